@@ -0,0 +1,272 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+/*
+ * The converter of the images to the asset files, see st7735s_asset.h.
+ * The input is the binary (P6) or plain (P3) PPM image; The PNG images
+ * can be piped from a converter, for example:
+ *   pngtopnm icon.png | ./lcdasset -p medium -t 16x16 - icon.lcda
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "st7735s.h"
+#include "st7735s_asset.h"
+#include "st7735s_convert.h"
+
+/* The image in the RGB888 format */
+typedef struct
+{
+	unsigned int width, height;
+	uint8 *pixels;
+} image_t;
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: lcdasset [-p full|medium|reduced] [-t WIDTHxHEIGHT] "
+		"input.ppm output.lcda\n"
+		"  -p  The pixel size of the display; full by default.\n"
+		"  -t  The size of the tiles; The whole image by default.\n"
+		"  Use - as the input to read the image from the standard input.\n");
+} /* usage */
+
+/*
+ * Read the number of the PPM header; The comments are skipped.
+ *
+ * Return: 0 - OK; 1 - The number is missing.
+ */
+static int readNumber(FILE *file, unsigned int *value)
+{
+	int c;
+	
+	for(;;)
+	{
+		c = fgetc(file);
+		if(c == '#') while((c != '\n') && (c != EOF)) c = fgetc(file);
+		else if((c != ' ') && (c != '\t') && (c != '\r') && (c != '\n')) break;
+	}
+	
+	if((c < '0') || (c > '9')) return 1;
+	for(*value = 0; (c >= '0') && (c <= '9'); c = fgetc(file))
+		*value = *value * 10 + (c - '0');
+	
+	return 0;
+} /* readNumber */
+
+/*
+ * Read the PPM image; The components are scaled to 8 bits.
+ *
+ * Return: 0 - OK; 1 - The file is not a valid PPM image.
+ */
+static int readPPM(FILE *file, image_t *image)
+{
+	unsigned int maximum, value, i;
+	size_t count;
+	char magic[2];
+	uint8 *raw;
+	
+	if(fread(magic, 1, 2, file) != 2) return 1;
+	if((magic[0] != 'P') || ((magic[1] != '6') && (magic[1] != '3'))) return 1;
+	
+	if(readNumber(file, &image->width) || readNumber(file, &image->height)
+	|| readNumber(file, &maximum)) return 1;
+	if((image->width == 0) || (image->height == 0)) return 1;
+	if((image->width > 0xFFFF) || (image->height > 0xFFFF)) return 1;
+	if((maximum == 0) || (maximum > 0xFFFF)) return 1;
+	
+	count = (size_t) image->width * image->height * 3;
+	image->pixels = (uint8 *) malloc(count);
+	if(image->pixels == NULL) return 1;
+	
+	/* The binary samples have 1 byte, or 2 bytes above 255 */
+	if(magic[1] == '6')
+	{
+		raw = (maximum > 255) ? (uint8 *) malloc(count * 2) : image->pixels;
+		if(raw == NULL) return 1;
+		if(fread(raw, (maximum > 255) ? 2 : 1, count, file) != count) return 1;
+	
+		for(i = 0; i < count; i++)
+		{
+			value = (maximum > 255) ? ((raw[2*i] << 8) | raw[2*i+1]) : raw[i];
+			image->pixels[i] = (value * 255 + maximum / 2) / maximum;
+		}
+		if(raw != image->pixels) free(raw);
+		return 0;
+	}
+	
+	for(i = 0; i < count; i++)
+	{
+		if(readNumber(file, &value) || (value > maximum)) return 1;
+		image->pixels[i] = (value * 255 + maximum / 2) / maximum;
+	}
+	
+	return 0;
+} /* readPPM */
+
+/* Write the little-endian numbers */
+static void write16(uint8 *p, unsigned int value)
+{
+	p[0] = value; p[1] = value >> 8;
+} /* write16 */
+
+static void write32(uint8 *p, unsigned long value)
+{
+	p[0] = value; p[1] = value >> 8; p[2] = value >> 16; p[3] = value >> 24;
+} /* write32 */
+
+/*
+ * Encode the image to the asset file.
+ *
+ * Return: 0 - OK; 1 - A write error.
+ */
+static int writeAsset(FILE *file, const image_t *image, uint8 pixel,
+					  unsigned int tileWidth, unsigned int tileHeight)
+{
+	lcdst_convert_t convert = lcdst_getConverter(ST7735S_SRC_RGB888, pixel);
+	unsigned int columns, rows, column, row, tw, th, i;
+	uint8 header[ST7735S_ASSET_HEADER + 4], *tile, *encoded;
+	unsigned long offset;
+	size_t count;
+	
+	columns = (image->width  + tileWidth  - 1) / tileWidth;
+	rows    = (image->height + tileHeight - 1) / tileHeight;
+	
+	memcpy(header, ST7735S_ASSET_MAGIC, 4);
+	header[4] = ST7735S_ASSET_VERSION;
+	header[5] = pixel;
+	write16(header + 6, image->width);
+	write16(header + 8, image->height);
+	write16(header + 10, (tileWidth == image->width) ? 0 : tileWidth);
+	write16(header + 12, (tileHeight == image->height) ? 0 : tileHeight);
+	write16(header + 14, 0);
+	write32(header + 16, (unsigned long) columns * rows);
+	if(fwrite(header, 1, ST7735S_ASSET_HEADER, file) != ST7735S_ASSET_HEADER)
+		return 1;
+	
+	/* The tile index; The tiles follow it in the same order */
+	offset = ST7735S_ASSET_HEADER + 4ul * columns * rows;
+	for(row = 0; row < rows; row++)
+	{
+		for(column = 0; column < columns; column++)
+		{
+			tw = image->width - column * tileWidth;
+			th = image->height - row * tileHeight;
+			if(tw > tileWidth)  tw = tileWidth;
+			if(th > tileHeight) th = tileHeight;
+	
+			write32(header, offset);
+			if(fwrite(header, 1, 4, file) != 4) return 1;
+			offset += lcdst_getEncodedSize(pixel, (size_t) tw * th);
+		}
+	}
+	
+	/* The reduced kernel needs the even count; One pixel of padding */
+	count = (size_t) tileWidth * tileHeight + 1;
+	tile = (uint8 *) malloc(count * 3);
+	encoded = (uint8 *) malloc(count * 3);
+	if((tile == NULL) || (encoded == NULL)) return 1;
+	
+	for(row = 0; row < rows; row++)
+	{
+		for(column = 0; column < columns; column++)
+		{
+			tw = image->width - column * tileWidth;
+			th = image->height - row * tileHeight;
+			if(tw > tileWidth)  tw = tileWidth;
+			if(th > tileHeight) th = tileHeight;
+	
+			/* Gather the rows of the tile one after another */
+			for(i = 0; i < th; i++)
+				memcpy(tile + (size_t) i * tw * 3, image->pixels
+					   + (((size_t) row * tileHeight + i) * image->width
+						  + (size_t) column * tileWidth) * 3, tw * 3);
+	
+			count = (size_t) tw * th;
+			memset(tile + count * 3, 0, 3);
+			convert(encoded, tile, (count + 1) & ~(size_t) 1);
+	
+			count = lcdst_getEncodedSize(pixel, count);
+			if(fwrite(encoded, 1, count, file) != count) return 1;
+		}
+	}
+	
+	free(encoded);
+	free(tile);
+	return 0;
+} /* writeAsset */
+
+int main(int argc, char *argv[])
+{
+	unsigned int tileWidth = 0, tileHeight = 0;
+	uint8 pixel = ST7735S_PIXEL_FULL;
+	image_t image = {0, 0, NULL};
+	FILE *input, *output;
+	int i, error;
+	
+	/* The options */
+	for(i = 1; (i < argc - 2) && (argv[i][0] == '-'); i += 2)
+	{
+		if(!strcmp(argv[i], "-p"))
+		{
+			if(!strcmp(argv[i+1], "full")) pixel = ST7735S_PIXEL_FULL;
+			else if(!strcmp(argv[i+1], "medium")) pixel = ST7735S_PIXEL_MEDIUM;
+			else if(!strcmp(argv[i+1], "reduced")) pixel = ST7735S_PIXEL_REDUCED;
+			else {usage(); return 1;}
+		}
+		else if(!strcmp(argv[i], "-t"))
+		{
+			if((sscanf(argv[i+1], "%ux%u", &tileWidth, &tileHeight) != 2)
+			|| (tileWidth == 0) || (tileHeight == 0)
+			|| (tileWidth > 0xFFFF) || (tileHeight > 0xFFFF))
+				{usage(); return 1;}
+		}
+		else {usage(); return 1;}
+	}
+	if(i != argc - 2) {usage(); return 1;}
+	
+	/* Read the image */
+	input = strcmp(argv[i], "-") ? fopen(argv[i], "rb") : stdin;
+	if(input == NULL)
+	{
+		fprintf(stderr, "Failed to open %s!\n", argv[i]);
+		return 1;
+	}
+	error = readPPM(input, &image);
+	if(input != stdin) fclose(input);
+	if(error)
+	{
+		fprintf(stderr, "Failed to read the PPM image %s!\n", argv[i]);
+		return 1;
+	}
+	
+	/* The tiles larger than the image are cut to it */
+	if((tileWidth == 0) || (tileWidth > image.width)) tileWidth = image.width;
+	if((tileHeight == 0) || (tileHeight > image.height))
+		tileHeight = image.height;
+	
+	/* Write the asset */
+	output = fopen(argv[i+1], "wb");
+	if(output == NULL)
+	{
+		fprintf(stderr, "Failed to create %s!\n", argv[i+1]);
+		return 1;
+	}
+	error = writeAsset(output, &image, pixel, tileWidth, tileHeight);
+	if(fclose(output)) error = 1;
+	if(error)
+	{
+		fprintf(stderr, "Failed to write %s!\n", argv[i+1]);
+		remove(argv[i+1]);
+		return 1;
+	}
+	
+	free(image.pixels);
+	return 0;
+} /* main */
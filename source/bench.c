@@ -0,0 +1,442 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "st7735s.h"
+#include "st7735s_sim.h"
+#include "st7735s_compose.h"
+
+/* The number of the frames drawn by every case */
+#define ITERATIONS 20
+
+/* The speed of the simulated SPI interface in Hz */
+#define SIM_SPEED 32000000
+
+/* The speeds reported as the modeled frames per second */
+static const double speeds[] = {16e6, 32e6, 62.5e6};
+#define SPEEDS (sizeof(speeds) / sizeof(speeds[0]))
+
+/* The bitmaps for the blit cases; Large enough for every orientation */
+static uint8 rgb888[160 * 160 * 3];
+static uint8 rgb565[160 * 160 * 2];
+
+/* The whole frame of the frame cases; The size of the moving sprite */
+static uint8 frame[160 * 160 * 2];
+#define SPRITE 12
+
+/* The cursor of the compositor case; Opaque with the soft edge */
+static uint8 cursor[16 * 16 * 4];
+
+/* One benchmark case; The function draws one frame */
+typedef struct
+{
+	const char *name;
+	void (*frame)(lcdst_t *display, uint8 w, uint8 h);
+} bench_t;
+
+/*
+ * The backend which only accepts the data.
+ * It measures the processor time of the library alone.
+ */
+static int nullTransfer(void *context, const uint8 *data, unsigned int length)
+{
+	(void) context; (void) data; (void) length;
+	return 0;
+} /* nullTransfer */
+
+static void nullSetDC(void *context, int level)
+{
+	(void) context; (void) level;
+} /* nullSetDC */
+
+static const lcdst_backend_t nullBackend =
+{
+	nullTransfer, NULL, nullSetDC, NULL, NULL, NULL
+};
+
+static void benchPx(lcdst_t *display, uint8 w, uint8 h)
+{
+	unsigned int i, seed = 1;
+	
+	/* The pixels in the pseudo-random order */
+	for(i = 0; i < 4096; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		lcdst_drawPxOn(display, (seed >> 16) % w, (seed >> 8) % h, i, 0, 255);
+	}
+} /* benchPx */
+
+static void benchHLine(lcdst_t *display, uint8 w, uint8 h)
+{
+	uint8 y;
+	
+	for(y = 0; y < h; y++) lcdst_drawHLineOn(display, 0, y, w, y, 255, 0);
+} /* benchHLine */
+
+static void benchVLine(lcdst_t *display, uint8 w, uint8 h)
+{
+	uint8 x;
+	
+	for(x = 0; x < w; x++) lcdst_drawVLineOn(display, x, 0, h, x, 0, 255);
+} /* benchVLine */
+
+static void benchRect(lcdst_t *display, uint8 w, uint8 h)
+{
+	uint8 i;
+	
+	for(i = 0; 2 * i < w && 2 * i < h; i++)
+		lcdst_drawRectOn(display, i, i, w - 2 * i, h - 2 * i, 255, i, 0);
+} /* benchRect */
+
+static void benchFRect(lcdst_t *display, uint8 w, uint8 h)
+{
+	unsigned int x, y;
+	
+	for(y = 0; y < h; y += 16)
+		for(x = 0; x < w; x += 16)
+			lcdst_drawFRectOn(display, x, y, 16, 16, x, y, 128);
+} /* benchFRect */
+
+static void benchList(lcdst_t *display, uint8 w, uint8 h)
+{
+	static uint8 list[100 * 11];
+	unsigned int x, y, n = 0;
+	
+	/* The tiles of drawFRect as one display list */
+	for(y = 0; y < h; y += 16)
+		for(x = 0; x < w; x += 16)
+		{
+			list[n++] = ST7735S_OP_WINDOW;
+			list[n++] = x; list[n++] = y;
+			list[n++] = x + 15; list[n++] = y + 15;
+			list[n++] = ST7735S_OP_FILL;
+			list[n++] = 0; list[n++] = 1; /* 256 pixels */
+			list[n++] = x; list[n++] = y; list[n++] = 128;
+		}
+	lcdst_executeOn(display, list, n);
+} /* benchList */
+
+static void benchScreen(lcdst_t *display, uint8 w, uint8 h)
+{
+	(void) w; (void) h;
+	lcdst_drawScreenOn(display, 0, 128, 255);
+} /* benchScreen */
+
+static void benchPushPx(lcdst_t *display, uint8 w, uint8 h)
+{
+	unsigned int i;
+	
+	lcdst_setWindowOn(display, 0, 0, w - 1, h - 1);
+	for(i = 0; i < (unsigned int) w * h; i++) lcdst_pushPxOn(display, i, 0, 0);
+	lcdst_sendBufferOn(display);
+} /* benchPushPx */
+
+static void benchBlit888(lcdst_t *display, uint8 w, uint8 h)
+{
+	lcdst_blitOn(display, 0, 0, w, h, rgb888, 0, ST7735S_SRC_RGB888);
+} /* benchBlit888 */
+
+static void benchBlit565(lcdst_t *display, uint8 w, uint8 h)
+{
+	lcdst_blitOn(display, 0, 0, w, h, rgb565, 0, ST7735S_SRC_RGB565);
+} /* benchBlit565 */
+
+static void benchOrdered(lcdst_t *display, uint8 w, uint8 h)
+{
+	lcdst_setDitherOn(display, ST7735S_DITHER_ORDERED);
+	lcdst_blitOn(display, 0, 0, w, h, rgb888, 0, ST7735S_SRC_RGB888);
+	lcdst_setDitherOn(display, ST7735S_DITHER_NONE);
+} /* benchOrdered */
+
+static void benchDiffusion(lcdst_t *display, uint8 w, uint8 h)
+{
+	lcdst_setDitherOn(display, ST7735S_DITHER_DIFFUSION);
+	lcdst_blitOn(display, 0, 0, w, h, rgb888, 0, ST7735S_SRC_RGB888);
+	lcdst_setDitherOn(display, ST7735S_DITHER_NONE);
+} /* benchDiffusion */
+
+static void benchFrameStatic(lcdst_t *display, uint8 w, uint8 h)
+{
+	(void) w; (void) h;
+	lcdst_pushFrameOn(display, rgb565, 0, ST7735S_SRC_RGB565);
+} /* benchFrameStatic */
+
+static void benchFrameSprite(lcdst_t *display, uint8 w, uint8 h)
+{
+	static unsigned int step;
+	unsigned int x, y, i;
+	
+	/* The producer draws the whole frame with the sprite on the gradient */
+	memcpy(frame, rgb565, (size_t) w * h * 2);
+	x = (step * 5) % (w - SPRITE);
+	y = (step * 3) % (h - SPRITE);
+	for(i = 0; i < SPRITE; i++)
+		memset(frame + ((y + i) * w + x) * 2, 0xFF, SPRITE * 2);
+	step++;
+	
+	lcdst_pushFrameOn(display, frame, 0, ST7735S_SRC_RGB565);
+} /* benchFrameSprite */
+
+static void benchCursor(lcdst_t *display, uint8 w, uint8 h)
+{
+	static lcdst_compositor_t *compositors[2];
+	static lcdst_sprite_t *sprites[2];
+	static lcdst_t *displays[2];
+	static unsigned int step;
+	unsigned int i;
+	
+	/* Every display has its compositor; Made again in the new orientation */
+	i = ((displays[0] == NULL) || (displays[0] == display)) ? 0 : 1;
+	if((compositors[i] == NULL) || (compositors[i]->width != w)
+	|| (compositors[i]->height != h))
+	{
+		lcdst_destroyCompositor(compositors[i]);
+		compositors[i] = lcdst_createCompositor(w, h);
+		lcdst_setBackground(compositors[i], 0, 0, w, h, rgb565, 0,
+							ST7735S_SRC_RGB565);
+		sprites[i] = lcdst_addSprite(compositors[i], cursor, 16, 16, 0);
+		lcdst_showSprite(compositors[i], sprites[i], 1);
+		displays[i] = display;
+	}
+	
+	/* The cursor moves by a few pixels every frame */
+	lcdst_moveSprite(compositors[i], sprites[i], (step * 3) % (w - 16),
+					 (step * 2) % (h - 16));
+	step++;
+	lcdst_composeOn(display, compositors[i]);
+} /* benchCursor */
+
+/* Render the band of the plasma; Every pixel costs some arithmetic */
+static void renderPlasma(void *user, uint8 *rows, uint8 y, uint8 width,
+						 uint8 height)
+{
+	unsigned int x, i, v;
+	
+	(void) user;
+	for(i = 0; i < height; i++, y++)
+		for(x = 0; x < width; x++, rows += 3)
+		{
+			v = (x * x + y * y) ^ (x * y);
+			rows[0] = v;
+			rows[1] = v >> 3;
+			rows[2] = (x + y) * 2;
+		}
+} /* renderPlasma */
+
+static void benchRender(lcdst_t *display, uint8 w, uint8 h)
+{
+	(void) w; (void) h;
+	lcdst_renderFrameOn(display, renderPlasma, NULL);
+} /* benchRender */
+
+static void benchText(lcdst_t *display, uint8 w, uint8 h)
+{
+	static const char text[] = "The quick brown fox jumps over the lazy dog";
+	uint8 y;
+	
+	(void) w;
+	for(y = 0; y + 8 <= h; y += 8)
+		lcdst_drawTextOn(display, 0, y, text + y % 16, &lcdst_font6x8,
+						 255, 255, 255, 0, 0, y);
+} /* benchText */
+
+static void benchLine(lcdst_t *display, uint8 w, uint8 h)
+{
+	int i;
+	
+	/* The star from the center to the edges */
+	for(i = 0; i < w; i += 4)
+	{
+		lcdst_drawLineOn(display, w / 2, h / 2, i, 0, 255, 255, 0);
+		lcdst_drawLineOn(display, w / 2, h / 2, i, h - 1, 255, 255, 0);
+	}
+	for(i = 0; i < h; i += 4)
+	{
+		lcdst_drawLineOn(display, w / 2, h / 2, 0, i, 0, 255, 255);
+		lcdst_drawLineOn(display, w / 2, h / 2, w - 1, i, 0, 255, 255);
+	}
+} /* benchLine */
+
+static void benchCircle(lcdst_t *display, uint8 w, uint8 h)
+{
+	int radius;
+	
+	for(radius = (w < h ? w : h) / 2; radius > 0; radius -= 8)
+		lcdst_fillCircleOn(display, w / 2, h / 2, radius, radius * 4, 0, 255);
+} /* benchCircle */
+
+static void benchArc(lcdst_t *display, uint8 w, uint8 h)
+{
+	int radius;
+	
+	/* The gauges; The full sweeps must draw the whole circles */
+	for(radius = (w < h ? w : h) / 2 - 1; radius > 8; radius -= 12)
+	{
+		lcdst_drawArcOn(display, w / 2, h / 2, radius, 0, 360, 255, 0, 0);
+		lcdst_drawArcOn(display, w / 2, h / 2, radius - 4, -90, 270, 0, 255, 0);
+		lcdst_drawArcOn(display, w / 2, h / 2, radius - 8, 135, 405, 0, 0, 255);
+	}
+} /* benchArc */
+
+static const bench_t cases[] =
+{
+	{"drawPx",        benchPx},
+	{"drawHLine",     benchHLine},
+	{"drawVLine",     benchVLine},
+	{"drawRect",      benchRect},
+	{"drawFRect",     benchFRect},
+	{"displayList",   benchList},
+	{"drawScreen",    benchScreen},
+	{"pushPx",        benchPushPx},
+	{"blitRGB888",    benchBlit888},
+	{"blitRGB565",    benchBlit565},
+	{"blitOrdered",   benchOrdered},
+	{"blitDiffusion", benchDiffusion},
+	{"frameStatic",   benchFrameStatic},
+	{"frameSprite",   benchFrameSprite},
+	{"composeCursor", benchCursor},
+	{"renderFrame",   benchRender},
+	{"drawText",      benchText},
+	{"drawLine",      benchLine},
+	{"fillCircle",    benchCircle},
+	{"drawArc",       benchArc}
+};
+#define CASES (sizeof(cases) / sizeof(cases[0]))
+
+/* The names of the pixel sizes in the output */
+static const struct
+{
+	uint8 pixel;
+	const char *name;
+} formats[] =
+{
+	{ST7735S_PIXEL_FULL, "full"},
+	{ST7735S_PIXEL_MEDIUM, "medium"},
+	{ST7735S_PIXEL_REDUCED, "reduced"}
+};
+#define FORMATS (sizeof(formats) / sizeof(formats[0]))
+
+/*
+ * Read the processor time of the process in nanoseconds.
+ */
+static double cpuTime(void)
+{
+	struct timespec time;
+	
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return time.tv_sec * 1e9 + time.tv_nsec;
+} /* cpuTime */
+
+/*
+ * Run the case on both displays and print its results.
+ */
+static void runCase(lcdst_t *sim, lcdst_t *null, const bench_t *test,
+					unsigned int format, uint8 orientation, int last)
+{
+	lcdst_simstats_t stats;
+#if ST7735S_CFG_STATS
+	lcdst_stats_t counters;
+#endif
+	uint8 w = lcdst_getWidthOn(sim), h = lcdst_getHeightOn(sim);
+	double start, cpu, wire, overhead, pixels;
+	unsigned int i;
+	
+	/* The traffic and the modeled time on the simulated panel */
+	lcdst_simResetStats(sim);
+#if ST7735S_CFG_STATS
+	lcdst_resetStatsOn(sim);
+#endif
+	for(i = 0; i < ITERATIONS; i++) test->frame(sim, w, h);
+	lcdst_sendBufferOn(sim);
+	lcdst_simGetStats(sim, &stats);
+	
+	/* The processor time without the simulation */
+	start = cpuTime();
+	for(i = 0; i < ITERATIONS; i++) test->frame(null, w, h);
+	lcdst_sendBufferOn(null);
+	cpu = cpuTime() - start;
+	
+	/* The cost of the messages and the D/C changes does not scale */
+	wire = stats.bytes * 8.0 / SIM_SPEED;
+	overhead = stats.busTime - wire;
+	pixels = stats.pixels ? (double) stats.pixels : 1.0;
+	
+	printf("    {\"primitive\": \"%s\", \"format\": \"%s\", "
+		   "\"orientation\": %d,\n", test->name, formats[format].name,
+		   orientation);
+	printf("     \"pixels\": %.1f, \"bytes\": %.1f, \"commandBytes\": %.1f, "
+		   "\"dataBytes\": %.1f,\n", stats.pixels / (double) ITERATIONS,
+		   stats.bytes / (double) ITERATIONS,
+		   stats.commandBytes / (double) ITERATIONS,
+		   stats.dataBytes / (double) ITERATIONS);
+	printf("     \"calls\": %.1f, \"transactions\": %.1f, \"dcChanges\": %.1f, "
+		   "\"nsPerPixel\": %.3f,\n", stats.calls / (double) ITERATIONS,
+		   stats.transactions / (double) ITERATIONS,
+		   stats.dcChanges / (double) ITERATIONS, cpu / pixels);
+#if ST7735S_CFG_STATS
+	/* The frame cases; The pixels sent needlessly by merging the tiles */
+	lcdst_getStatsOn(sim, &counters);
+	if(counters.frames)
+		printf("     \"tiles\": %.1f, \"tilePixels\": %.1f, "
+			   "\"mergeOverhead\": %.3f, \"nsDiff\": %.0f,\n",
+			   counters.tiles / (double) counters.frames,
+			   counters.tilePixels / (double) counters.frames,
+			   counters.tilePixels ? (double) counters.framePixels
+			   / counters.tilePixels - 1.0 : 0.0,
+			   counters.diffNs / (double) counters.frames);
+#endif
+	printf("     \"fps\": [");
+	for(i = 0; i < SPEEDS; i++)
+		printf("%s%.2f", i ? ", " : "",
+			   ITERATIONS / (stats.bytes * 8.0 / speeds[i] + overhead));
+	printf("]}%s\n", last ? "" : ",");
+} /* runCase */
+
+int main(void)
+{
+	lcdst_t *sim, *null;
+	unsigned int format, test, i;
+	uint8 orientation;
+	
+	/* The gradient for the blit cases */
+	for(i = 0; i < sizeof(rgb888); i++) rgb888[i] = i * 7;
+	for(i = 0; i < sizeof(rgb565); i++) rgb565[i] = i * 13;
+	for(i = 0; i < sizeof(cursor); i++)
+		cursor[i] = (i % 4 != 3) ? 255 : ((i / 4) % 16 % 15 ? 255 : 96);
+	
+	sim = lcdst_initSim(SIM_SPEED);
+	null = lcdst_initBackend(&nullBackend, NULL);
+	
+	printf("{\n  \"iterations\": %d,\n  \"speeds\": [", ITERATIONS);
+	for(i = 0; i < SPEEDS; i++) printf("%s%.0f", i ? ", " : "", speeds[i]);
+	printf("],\n  \"results\": [\n");
+	
+	for(format = 0; format < FORMATS; format++)
+	{
+		for(orientation = 0; orientation < 4; orientation++)
+		{
+			lcdst_setPixelFormatOn(sim, formats[format].pixel);
+			lcdst_setPixelFormatOn(null, formats[format].pixel);
+			lcdst_setOrientationOn(sim, orientation);
+			lcdst_setOrientationOn(null, orientation);
+	
+			for(test = 0; test < CASES; test++)
+				runCase(sim, null, &cases[test], format, orientation,
+						(format == FORMATS - 1) && (orientation == 3)
+						&& (test == CASES - 1));
+		}
+	}
+	
+	printf("  ]\n}\n");
+	
+	lcdst_uninit(null);
+	lcdst_uninit(sim);
+	return 0;
+} /* main */
@@ -0,0 +1,236 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C++17
+ */
+
+/*
+ * The comparison of the C API with the C++ template of st7735s.hpp.
+ * Both draw the same frames to the transports, which only accept the data,
+ * so only the processor time of the drawing is measured.
+ */
+
+#include <cstdio>
+#include <ctime>
+#include "st7735s.hpp"
+
+/* The number of the frames drawn by every case */
+#define ITERATIONS 50
+
+/* The bitmaps for the blit cases */
+static uint8 rgb888[128 * 160 * 3];
+static uint8 rgb565[128 * 160 * 2];
+
+/* The transport of the template; The barrier keeps the encoded bytes */
+struct NullBackend
+{
+	void transfer(const uint8 *data, unsigned int length)
+	{
+		asm volatile("" : : "r"(data), "r"(length) : "memory");
+	} /* transfer */
+
+	void setDC(int level) {(void) level;}
+	void delay(unsigned int milliseconds) {(void) milliseconds;}
+};
+
+/* The backend of the C API */
+static int nullTransfer(void *context, const uint8 *data, unsigned int length)
+{
+	(void) context; (void) data; (void) length;
+	return 0;
+} /* nullTransfer */
+
+static void nullSetDC(void *context, int level)
+{
+	(void) context; (void) level;
+} /* nullSetDC */
+
+static const lcdst_backend_t nullBackend =
+{
+	nullTransfer, nullptr, nullSetDC, nullptr, nullptr, nullptr
+};
+
+/*
+ * The cases; Every case draws one frame on the C display and on the template
+ * and returns the number of the pixels.
+ */
+template<class D>
+static unsigned long pushPx(lcdst_t *display, D *d)
+{
+	unsigned int i, count = D::width * D::height;
+
+	if(display != nullptr)
+	{
+		lcdst_setWindowOn(display, 0, 0, D::width - 1, D::height - 1);
+		for(i = 0; i < count; i++) lcdst_pushPxOn(display, i, i >> 8, 0);
+		lcdst_sendBufferOn(display);
+		return count;
+	}
+
+	d->setWindow(0, 0, D::width - 1, D::height - 1);
+	for(i = 0; i < count; i++) d->pushPx(i, i >> 8, 0);
+	d->flush();
+	return count;
+} /* pushPx */
+
+template<class D>
+static unsigned long drawPx(lcdst_t *display, D *d)
+{
+	unsigned int i, seed = 1;
+	uint8 x, y;
+
+	/* The pixels in the pseudo-random order */
+	for(i = 0; i < 4096; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		x = (seed >> 16) % D::width;
+		y = (seed >> 8) % D::height;
+		if(display != nullptr) lcdst_drawPxOn(display, x, y, i, 0, 255);
+		else d->drawPx(x, y, i, 0, 255);
+	}
+	if(display == nullptr) d->flush();
+	return 4096;
+} /* drawPx */
+
+template<class D>
+static unsigned long drawHLine(lcdst_t *display, D *d)
+{
+	uint8 y;
+
+	for(y = 0; y < D::height; y++)
+	{
+		if(display != nullptr)
+			lcdst_drawHLineOn(display, 0, y, D::width, y, 255, 0);
+		else d->span(0, y, D::width, y, 255, 0);
+	}
+	if(display == nullptr) d->flush();
+	return D::width * D::height;
+} /* drawHLine */
+
+template<class D>
+static unsigned long drawFRect(lcdst_t *display, D *d)
+{
+	unsigned int x, y;
+
+	for(y = 0; y < D::height; y += 16)
+		for(x = 0; x < D::width; x += 16)
+		{
+			if(display != nullptr)
+				lcdst_drawFRectOn(display, x, y, 16, 16, x, y, 128);
+			else d->fill(x, y, 16, 16, x, y, 128);
+		}
+	if(display == nullptr) d->flush();
+	return D::width * D::height;
+} /* drawFRect */
+
+template<class D>
+static unsigned long blitRGB888(lcdst_t *display, D *d)
+{
+	if(display != nullptr)
+		lcdst_blitOn(display, 0, 0, D::width, D::height, rgb888, 0,
+					 ST7735S_SRC_RGB888);
+	else
+	{
+		d->template blit<ST7735S_SRC_RGB888>(0, 0, D::width, D::height, rgb888);
+		d->flush();
+	}
+	return D::width * D::height;
+} /* blitRGB888 */
+
+template<class D>
+static unsigned long blitRGB565(lcdst_t *display, D *d)
+{
+	if(display != nullptr)
+		lcdst_blitOn(display, 0, 0, D::width, D::height, rgb565, 0,
+					 ST7735S_SRC_RGB565);
+	else
+	{
+		d->template blit<ST7735S_SRC_RGB565>(0, 0, D::width, D::height, rgb565);
+		d->flush();
+	}
+	return D::width * D::height;
+} /* blitRGB565 */
+
+/*
+ * Read the processor time of the process in nanoseconds.
+ */
+static double cpuTime(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+	return time.tv_sec * 1e9 + time.tv_nsec;
+} /* cpuTime */
+
+/*
+ * Run the cases in one pixel size and print their results.
+ */
+template<uint8 Pixel>
+static void runFormat(const char *format, int last)
+{
+	typedef lcdst::Display<NullBackend, Pixel> D;
+	typedef unsigned long (*frame_t)(lcdst_t *, D *);
+	static const struct
+	{
+		const char *name;
+		frame_t frame;
+	} cases[] =
+	{
+		{"pushPx",     pushPx<D>},
+		{"drawPx",     drawPx<D>},
+		{"drawHLine",  drawHLine<D>},
+		{"drawFRect",  drawFRect<D>},
+		{"blitRGB888", blitRGB888<D>},
+		{"blitRGB565", blitRGB565<D>}
+	};
+	const unsigned int count = sizeof(cases) / sizeof(cases[0]);
+	lcdst_t *display = lcdst_initBackend(&nullBackend, nullptr);
+	D *d = new D();
+	double start, c, cpp;
+	unsigned long pixels;
+	unsigned int test, i;
+
+	lcdst_setPixelFormatOn(display, Pixel);
+	d->begin();
+
+	for(test = 0; test < count; test++)
+	{
+		start = cpuTime();
+		for(i = pixels = 0; i < ITERATIONS; i++)
+			pixels += cases[test].frame(display, nullptr);
+		c = (cpuTime() - start) / pixels;
+
+		start = cpuTime();
+		for(i = pixels = 0; i < ITERATIONS; i++)
+			pixels += cases[test].frame(nullptr, d);
+		cpp = (cpuTime() - start) / pixels;
+
+		printf("    {\"primitive\": \"%s\", \"format\": \"%s\", "
+			   "\"nsPerPixelC\": %.3f, \"nsPerPixelCpp\": %.3f, "
+			   "\"speedup\": %.2f}%s\n", cases[test].name, format, c, cpp,
+			   cpp > 0.0 ? c / cpp : 0.0,
+			   (last && (test == count - 1)) ? "" : ",");
+	}
+
+	delete d;
+	lcdst_uninit(display);
+} /* runFormat */
+
+int main(void)
+{
+	unsigned int i;
+
+	/* The gradient for the blit cases */
+	for(i = 0; i < sizeof(rgb888); i++) rgb888[i] = i * 7;
+	for(i = 0; i < sizeof(rgb565); i++) rgb565[i] = i * 13;
+
+	printf("{\n  \"iterations\": %d,\n  \"results\": [\n", ITERATIONS);
+	runFormat<ST7735S_PIXEL_FULL>("full", 0);
+	runFormat<ST7735S_PIXEL_MEDIUM>("medium", 0);
+	runFormat<ST7735S_PIXEL_REDUCED>("reduced", 1);
+	printf("  ]\n}\n");
+
+	return 0;
+} /* main */
@@ -43,6 +43,7 @@ int main(int argc, char *argv[])
 	lcdst_setWindow(20, 20, 29, 29);
 	for(uint8 i=0; i<100; i++) lcdst_pushPx(255, 0, 255);
 	lcdst_setWindow(0, 0, 127, 159); /* Optional reset */
+	lcdst_sendBuffer();
 	
 	/* Uninitialize the display */
 	//lcdst_uninit(myDisplay);
@@ -9,461 +9,2739 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
 #include "st7735s.h"
+#include "st7735s_convert.h"
 
-/********************************** EASY PORT *********************************/
 /*
- * If you porting this code, you can change below headers and function pointers
- * in gpio structure.
+ * The cost of one window setup expressed in pixels. The dirty rectangles are
+ * merged, when it is cheaper to send the additional pixels.
  */
-#include <wiringPi.h>
-#include <wiringPiSPI.h>
-struct
+#define WINDOW_COST 32
+
+/*
+ * The number of rows of the frame memory and of the rows which are visible.
+ * The scrolling areas are defined for all rows of the frame memory.
+ */
+#define GRAM_ROWS 162
+#define PANEL_ROWS 160
+
+/*
+ * The number of frames in the queue of the transmit thread. There are two
+ * framebuffers, so at most the frame being sent and the next one wait.
+ */
+#define ASYNC_FRAMES 2
+
+/* The frame submitted to the transmit thread */
+typedef struct
+{
+	uint8 *framebuffer;
+	lcdst_rect_t dirty[ST7735S_CFG_DIRTY + 1];
+	uint8 dirtyCount, width, height, pixel, dither;
+} frame_t;
+
+/*
+ * The state of the asynchronous mode of one display. The frames are passed
+ * through the single-producer/single-consumer ring. The drawing thread
+ * only advances 'head' and the transmit thread only advances 'tail',
+ * so 'head' is the number of submitted frames and 'tail' of sent frames.
+ */
+struct lcdst_async
+{
+	lcdst_t sender; /* The transmit queue and the window shadow of the thread */
+	uint8 *buffers[2];
+	frame_t frames[ASYNC_FRAMES];
+	atomic_uint head, tail;
+	atomic_uint error; /* 1 = The thread failed to send a frame */
+	sem_t work, done;
+	pthread_t thread;
+	int event;
+	lcdst_callback_t callback;
+	void *user;
+};
+
+/*
+ * The render threads of one display. The frame is described by the fields
+ * before 'next'; They are set before the threads are woken up. The threads
+ * take the bands from 'next' and mark every finished band in 'ready'
+ * with the number of the frame, so the marks need not be cleared.
+ */
+struct lcdst_render
+{
+	lcdst_render_t render;
+	void *user;
+	lcdst_convert_t convert; /* NULL in the framebuffer mode */
+	uint8 width, height, bandHeight, pixel, dither;
+	unsigned int bands, frame;
+	atomic_uint next;
+	atomic_uint ready[PANEL_ROWS];
+	uint8 *rows;             /* The RGB888 frame */
+	uint8 *encoded;          /* The frame in the pixel size of the display */
+	sem_t work, done, idle;
+	uint8 stop;
+	unsigned int count;
+	pthread_t *threads;
+};
+
+/*
+ * The lock of one SPI bus. The displays on the different chip selects
+ * of one bus share it, so their transfers and D/C changes do not mix.
+ * The display without the bus number has its own lock.
+ */
+struct lcdst_bus
+{
+	int number;
+	unsigned int users;
+	pthread_mutex_t lock;
+	struct lcdst_bus *next;
+};
+
+/* The global variable that stores the pointer to the structure,
+ * with the current active display.
+ */
+static lcdst_t *activeDisplay;
+
+/* The list of the shared buses and its lock */
+static struct lcdst_bus *buses;
+static pthread_mutex_t busesLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Safe allocation of the memory block.
+ *
+ * Parameters:
+ *   size - Size of memory block to allocate.
+ *
+ * Return:
+ *   Pointer to the memory block. If an error occurs, stop the program.
+ */
+static inline void *safeMalloc(size_t size)
+{
+	void *memoryBlock = (void*) malloc(size);
+	
+	/* Check the pointer */
+	if(memoryBlock == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return memoryBlock;
+} /* safeMalloc */
+
+/*
+ * Wait the specified time using the backend of the display.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ *   milliseconds - The time to wait.
+ */
+static void waitFor(lcdst_t *display, unsigned int milliseconds)
+{
+	struct timespec time;
+	
+	if(display->backend->delay != NULL)
+	{
+		display->backend->delay(display->context, milliseconds);
+		return;
+	}
+	
+	time.tv_sec  = milliseconds / 1000;
+	time.tv_nsec = (milliseconds % 1000) * 1000000L;
+	while(nanosleep(&time, &time) == -1 && errno == EINTR);
+} /* waitFor */
+
+static void asyncWait(lcdst_t *display, unsigned int pending);
+static void stopAsync(lcdst_t *display);
+static void stopRender(lcdst_t *display);
+
+#if ST7735S_CFG_STATS
+/*
+ * Read the monotonic clock in nanoseconds.
+ */
+static inline unsigned long long clockNs(void)
+{
+	struct timespec time;
+	
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000ULL + time.tv_nsec;
+} /* clockNs */
+
+/*
+ * Count the segments handed over in one call of the backend transfer
+ * and call the trace function.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ *   segments - The sent segments.
+ *   count - The number of the segments.
+ *   level - The level of the D/C line before the call.
+ *   start - The time before the call.
+ */
+static void countTransfer(lcdst_t *display, const lcdst_segment_t *segments,
+						  unsigned int count, uint8 level,
+						  unsigned long long start)
+{
+	unsigned long long time = clockNs() - start;
+	lcdst_stats_t *stats = &display->stats;
+	unsigned int i;
+	
+	for(i = 0; i < count; i++)
+	{
+		if(segments[i].dc) stats->dataBytes += segments[i].length;
+		else stats->commands += segments[i].length;
+		
+		if(segments[i].dc != level) stats->dcToggles++;
+		level = segments[i].dc;
+	}
+	
+	stats->transfers++;
+	stats->transportNs += time;
+	if(display->trace != NULL)
+		display->trace(display->traceUser, segments, count, time);
+} /* countTransfer */
+
+/*
+ * Count one sending of the transmit queue in the latency histogram.
+ */
+static void countFlush(lcdst_t *display, unsigned long long start)
+{
+	unsigned long long micro = (clockNs() - start) / 1000;
+	unsigned int bucket = 0;
+	
+	while(micro && (bucket < ST7735S_STATS_BUCKETS - 1)) {micro >>= 1; bucket++;}
+	display->stats.latency[bucket]++;
+	display->stats.flushes++;
+} /* countFlush */
+
+/*
+ * Add the counters of the transmit thread to the counters of the display.
+ */
+static void addStats(lcdst_stats_t *to, const lcdst_stats_t *from)
+{
+	unsigned int i;
+	
+	to->commands += from->commands;
+	to->dataBytes += from->dataBytes;
+	to->transfers += from->transfers;
+	to->dcToggles += from->dcToggles;
+	to->windows += from->windows;
+	to->flushes += from->flushes;
+	to->frames += from->frames;
+	to->tiles += from->tiles;
+	to->tilePixels += from->tilePixels;
+	to->framePixels += from->framePixels;
+	to->diffNs += from->diffNs;
+	to->transportNs += from->transportNs;
+	for(i = 0; i < ST7735S_STATS_BUCKETS; i++)
+		to->latency[i] += from->latency[i];
+} /* addStats */
+
+/*
+ * Count one frame of lcdst_pushFrame() and the time of its comparison.
+ */
+static void countFrame(lcdst_t *display, unsigned int tiles,
+					   unsigned long tilePixels, unsigned long framePixels,
+					   unsigned long long start)
+{
+	lcdst_stats_t *stats = &display->stats;
+	
+	stats->frames++;
+	stats->tiles += tiles;
+	stats->tilePixels += tilePixels;
+	stats->framePixels += framePixels;
+	stats->diffNs += clockNs() - start;
+} /* countFrame */
+#else
+/* Without the counters the calls are removed by the compiler */
+static inline unsigned long long clockNs(void) {return 0;}
+static inline void countTransfer(lcdst_t *display,
+								 const lcdst_segment_t *segments,
+								 unsigned int count, uint8 level,
+								 unsigned long long start)
+{
+	(void) display; (void) segments; (void) count; (void) level; (void) start;
+} /* countTransfer */
+static inline void countFlush(lcdst_t *display, unsigned long long start)
+{
+	(void) display; (void) start;
+} /* countFlush */
+static inline void countFrame(lcdst_t *display, unsigned int tiles,
+							  unsigned long tilePixels,
+							  unsigned long framePixels,
+							  unsigned long long start)
+{
+	(void) display; (void) tiles; (void) tilePixels; (void) framePixels;
+	(void) start;
+} /* countFrame */
+#endif /* ST7735S_CFG_STATS */
+
+/*
+ * Send the segments collected in the transmit queue to the display driver.
+ * If the backend can chain the segments, the whole queue is handed over
+ * in one call. Otherwise each segment is sent separately and the D/C line
+ * is set only when its level changes.
+ * In the asynchronous mode the submitted frames are sent first.
+ * The failed transfer is remembered in 'sendError' until it is reported.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ */
+static void flushQueue(lcdst_t *display)
+{
+	const lcdst_backend_t *backend = display->backend;
+	const lcdst_segment_t *segment = display->segments;
+	unsigned long long start, flushStart;
+	unsigned int i;
+	uint8 level;
+	int error = 0;
+	
+	if(display->segCount == 0) return;
+	if(display->async != NULL) asyncWait(display, 0);
+	
+	pthread_mutex_lock(&display->bus->lock);
+	flushStart = clockNs();
+	if(backend->transferv != NULL)
+	{
+		/* The backend sets the D/C line itself */
+		level = display->dcLevel;
+		error = backend->transferv(display->context, segment,
+								   display->segCount);
+		display->dcLevel = segment[display->segCount - 1].dc;
+		countTransfer(display, segment, display->segCount, level, flushStart);
+	}
+	else for(i = 0; i < display->segCount; i++, segment++)
+	{
+		start = clockNs();
+		level = display->dcLevel;
+		if(segment->dc != level)
+		{
+			backend->setDC(display->context, segment->dc);
+			display->dcLevel = segment->dc;
+		}
+		error |= backend->transfer(display->context, segment->data,
+								   segment->length);
+		countTransfer(display, segment, 1, level, start);
+	}
+	countFlush(display, flushStart);
+	pthread_mutex_unlock(&display->bus->lock);
+	
+	if(error) display->sendError = 1;
+	display->segCount = 0;
+	display->txLength = 0;
+} /* flushQueue */
+
+/*
+ * Report the failed transfers of the display and of its transmit thread
+ * and forget them.
+ *
+ * Return: 0 - All transfers succeeded; 1 - A transfer failed.
+ */
+static uint8 takeError(lcdst_t *display)
+{
+	uint8 error = display->sendError;
+	
+	display->sendError = 0;
+	if((display->async != NULL)
+	&& atomic_exchange_explicit(&display->async->error, 0,
+								memory_order_relaxed)) error = 1;
+	
+	return error;
+} /* takeError */
+
+/*
+ * Append one byte to the transmit queue. The byte extends the last segment
+ * if it has the same D/C level and ends in the buffer, otherwise a new
+ * segment is started. The queue is sent when the buffer or the segment list
+ * is full.
+ *
+ * Parameters:
+ *   byte - The byte to append.
+ *   dc - The level of the Data/Command line; 0 = command; 1 = data.
+ */
+static inline void queueByte(lcdst_t *display, uint8 byte, uint8 dc)
+{
+	lcdst_segment_t *last = display->segments + display->segCount - 1;
+	
+	if((display->segCount == 0) || (last->dc != dc)
+	|| (last->data + last->length != display->txBuffer + display->txLength))
+	{
+		if(display->segCount == display->segSize) flushQueue(display);
+		last = display->segments + display->segCount++;
+		last->data = display->txBuffer + display->txLength;
+		last->length = 0;
+		last->dc = dc;
+	}
+	
+	display->txBuffer[display->txLength++] = byte;
+	last->length++;
+	
+	if(display->txLength == display->txSize) flushQueue(display);
+} /* queueByte */
+
+/*
+ * Append the data segment, which refers to the memory outside
+ * of the transmit buffer. The memory must not change until the queue is sent.
+ *
+ * Parameters:
+ *   data - Pointer to the data.
+ *   length - The number of bytes.
+ */
+static inline void queueData(lcdst_t *display, const uint8 *data,
+							 unsigned int length)
+{
+	lcdst_segment_t *segment;
+	
+	if(length == 0) return;
+	if(display->segCount == display->segSize) flushQueue(display);
+	
+	segment = display->segments + display->segCount++;
+	segment->data = data;
+	segment->length = length;
+	segment->dc = 1;
+} /* queueData */
+
+/*
+ * Reserve the space for the data bytes at the end of the transmit buffer.
+ * The caller writes the data directly to the returned memory.
+ *
+ * Parameters:
+ *   length - The number of bytes; Not greater than the buffer size.
+ *
+ * Return: Pointer to the reserved space.
+ */
+static uint8 *reserveData(lcdst_t *display, unsigned int length)
+{
+	lcdst_segment_t *last;
+	uint8 *space;
+	
+	if(display->txSize - display->txLength < length) flushQueue(display);
+	
+	last = display->segments + display->segCount - 1;
+	if((display->segCount == 0) || (last->dc != 1)
+	|| (last->data + last->length != display->txBuffer + display->txLength))
+	{
+		if(display->segCount == display->segSize) flushQueue(display);
+		last = display->segments + display->segCount++;
+		last->data = display->txBuffer + display->txLength;
+		last->length = 0;
+		last->dc = 1;
+	}
+	
+	space = display->txBuffer + display->txLength;
+	display->txLength += length;
+	last->length += length;
+	
+	return space;
+} /* reserveData */
+
+static inline void endPixels(lcdst_t *display);
+
+/*
+ * Write the command to the transmit queue of the display driver.
+ *
+ * Parameters:
+ *   cmd - The command to write.
+ */
+static inline void writeCommand(lcdst_t *display, uint8 cmd)
+{
+	endPixels(display);
+	queueByte(display, cmd, 0);
+	
+	/* Every command ends the memory write; RAMWR starts it again */
+	display->streaming = (cmd == ST7735S_CMD_RAMWR);
+	display->streamCount = 0;
+} /* writeCommand */
+
+/*
+ * Write the data to the transmit queue of the display driver.
+ *
+ * Parameters:
+ *   data - The data to write.
+ */
+static inline void writeData(lcdst_t *display, uint8 data)
+{
+	queueByte(display, data, 1);
+} /* writeData */
+
+/*
+ * Compute the number of pixels in the rectangle.
+ */
+static inline unsigned int rectArea(const lcdst_rect_t *rect)
+{
+	return (rect->x2 - rect->x1 + 1) * (rect->y2 - rect->y1 + 1);
+} /* rectArea */
+
+/*
+ * Compute the bounding rectangle of the two rectangles.
+ */
+static inline lcdst_rect_t rectUnion(const lcdst_rect_t *a,
+									 const lcdst_rect_t *b)
+{
+	lcdst_rect_t result;
+	
+	result.x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+	result.y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+	result.x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+	result.y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+	
+	return result;
+} /* rectUnion */
+
+/*
+ * Compute the number of pixels sent needlessly, if the two rectangles
+ * are sent as their bounding rectangle.
+ */
+static inline int mergeWaste(const lcdst_rect_t *a, const lcdst_rect_t *b)
+{
+	lcdst_rect_t bound = rectUnion(a, b);
+	return (int) rectArea(&bound) - (int) rectArea(a) - (int) rectArea(b);
+} /* mergeWaste */
+
+/*
+ * Add the rectangle to the list of at most ST7735S_CFG_DIRTY rectangles.
+ * The rectangles are merged, when sending them as one window costs
+ * less than the setup of the second window. When the list is full,
+ * the pair with the smallest waste is merged.
+ *
+ * Parameters:
+ *   list - The rectangles; It has one spare place.
+ *   count - The number of the rectangles in the list.
+ *   rect - The new rectangle.
+ */
+static void mergeRect(lcdst_rect_t *list, uint8 *count, lcdst_rect_t rect)
+{
+	unsigned int i, j, bestI = 0, bestJ = 1;
+	int waste, bestWaste;
+	
+	for(;;)
+	{
+		/* Find the rectangle which is cheap to merge */
+		for(i = 0; i < *count; i++)
+			if(mergeWaste(&rect, &list[i]) <= WINDOW_COST) break;
+		if(i == *count) break;
+		
+		/* Take it out of the list and try again with the bigger one */
+		rect = rectUnion(&rect, &list[i]);
+		list[i] = list[--*count];
+	}
+	
+	/* The list has one spare place for the new rectangle */
+	list[(*count)++] = rect;
+	if(*count <= ST7735S_CFG_DIRTY) return;
+	
+	/* Merge the cheapest pair to make the place */
+	bestWaste = mergeWaste(&list[0], &list[1]);
+	for(i = 0; i < *count; i++)
+		for(j = i + 1; j < *count; j++)
+		{
+			waste = mergeWaste(&list[i], &list[j]);
+			if(waste < bestWaste) {bestWaste = waste; bestI = i; bestJ = j;}
+		}
+	
+	list[bestI] = rectUnion(&list[bestI], &list[bestJ]);
+	list[bestJ] = list[--*count];
+} /* mergeRect */
+
+/*
+ * Add the rectangle to the dirty list of the display.
+ */
+static void markDirty(lcdst_t *display, uint8 x1, uint8 y1, uint8 x2, uint8 y2)
+{
+	lcdst_rect_t rect = {x1, y1, x2, y2};
+	mergeRect(display->dirty, &display->dirtyCount, rect);
+} /* markDirty */
+
+/*
+ * Allocate the fill chunk of the display. Its size is the multiple of 6,
+ * so it holds whole patterns of every pixel size (2 or 3 bytes).
+ *
+ * Return: 0 on success; 1 on error.
+ */
+static uint8 allocFillChunk(lcdst_t *display, unsigned int size)
+{
+	uint8 *chunk;
+	
+	size -= size % 6;
+	if(size == 0) size = 6;
+	
+	/* The aligned size must be the multiple of the alignment */
+	chunk = (uint8 *) aligned_alloc(64, (size + 63) & ~63u);
+	if(chunk == NULL) return 1;
+	
+	free(display->fillChunk);
+	display->fillChunk = chunk;
+	display->fillSize = size;
+	display->fillValid = 0;
+	
+	return 0;
+} /* allocFillChunk */
+
+/*
+ * Take the lock of the bus. The shared bus is found by its number
+ * or created; The negative number gives the own lock.
+ *
+ * Return: Pointer to the bus.
+ */
+static struct lcdst_bus *joinBus(int number)
+{
+	struct lcdst_bus *bus;
+	
+	pthread_mutex_lock(&busesLock);
+	for(bus = buses; bus != NULL; bus = bus->next)
+		if((number >= 0) && (bus->number == number)) break;
+	
+	if(bus == NULL)
+	{
+		bus = (struct lcdst_bus *) safeMalloc(sizeof(struct lcdst_bus));
+		bus->number = number;
+		bus->users = 0;
+		pthread_mutex_init(&bus->lock, NULL);
+		bus->next = buses;
+		buses = bus;
+	}
+	bus->users++;
+	pthread_mutex_unlock(&busesLock);
+	
+	return bus;
+} /* joinBus */
+
+/*
+ * Release the lock of the bus. The last user destroys it.
+ */
+static void leaveBus(struct lcdst_bus *bus)
+{
+	struct lcdst_bus **link;
+	
+	pthread_mutex_lock(&busesLock);
+	if(--bus->users == 0)
+	{
+		for(link = &buses; *link != bus; link = &(*link)->next);
+		*link = bus->next;
+		pthread_mutex_destroy(&bus->lock);
+		free(bus);
+	}
+	pthread_mutex_unlock(&busesLock);
+} /* leaveBus */
+
+/*
+ * Allocate the row buffer of the dithering for the widest orientation.
+ */
+static void allocDither(lcdst_t *display)
+{
+	display->ditherRow = (uint8 *) safeMalloc(PANEL_ROWS * 3);
+	display->ditherError = (short *)
+		safeMalloc((PANEL_ROWS + 2) * 3 * sizeof(short));
+} /* allocDither */
+
+/*
+ * Create the structure with display data and its transmit queue.
+ *
+ * Parameters:
+ *   backend - The transport backend of the display.
+ *   context - The context passed to the backend functions.
+ *   bus - The number of the SPI bus; -1 = not shared.
+ *
+ * Return: Pointer to the structure with display data.
+ */
+static lcdst_t *createDisplay(const lcdst_backend_t *backend, void *context,
+							  int bus)
+{
+	lcdst_t *instance = (lcdst_t *) safeMalloc(sizeof(lcdst_t));
+	
+	instance->cs = instance->a0 = instance->rs = -1;
+	instance->backend = backend;
+	instance->context = context;
+	instance->bus = joinBus(bus);
+	instance->framebuffer = NULL;
+	instance->dirtyCount = 0;
+	instance->async = NULL;
+	instance->render = NULL;
+	instance->pixel = ST7735S_CFG_PIXEL;
+	instance->halfPending = 0;
+	instance->orientation = 0;
+	instance->panelValid = 0;
+	instance->streaming = 0;
+	instance->streamCount = 0;
+	instance->scrollTop = instance->scrollBottom = 0;
+	instance->scrollArea = instance->scrollPos = 0;
+	instance->dcLevel = 2; /* Unknown */
+	instance->sendError = 0;
+	instance->dither = ST7735S_DITHER_NONE;
+	allocDither(instance);
+	instance->tileWidth = instance->tileHeight = ST7735S_CFG_TILE;
+	instance->tilesValid = 0;
+	instance->tileHashes = NULL;
+	instance->refs = NULL;
+	instance->refCount = 0;
+#if ST7735S_CFG_STATS
+	memset(&instance->stats, 0, sizeof(instance->stats));
+	instance->trace = NULL;
+#endif
+	
+	/* Create the transmit queue */
+	instance->txSize = ST7735S_CFG_CHUNK;
+	instance->txLength = 0;
+	instance->txBuffer = (uint8 *) safeMalloc(instance->txSize);
+	instance->segSize = ST7735S_CFG_SEGMENTS;
+	instance->segCount = 0;
+	instance->segments = (lcdst_segment_t *)
+		safeMalloc(instance->segSize * sizeof(lcdst_segment_t));
+	
+	/* Create the fill chunk */
+	instance->fillChunk = NULL;
+	if(allocFillChunk(instance, ST7735S_CFG_CHUNK))
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	/*
+	 * instance->width; instance->height
+	 * The setting of this variables will take place
+	 * in the function lcdst_setOrientationOn(display) in startDisplay().
+	 */
+	
+	return instance;
+} /* createDisplay */
+
+/*
+ * The start sequence of the display driver. Every step is the command,
+ * the number of its parameters, the parameters and the time to wait
+ * after it in milliseconds. The waits are the minimums of the datasheet.
+ */
+static const uint8 startSequence[] =
+{
+	/* Software reset; 5ms to the next command, but 120ms to Sleep Out */
+	ST7735S_CMD_SWRESET, 0, 120,
+	
+	/* Sleep out; 5ms to the next command */
+	ST7735S_CMD_SLPOUT, 0, 5,
+	
+	/* Gamma curve 3, like lcdst_setGamma(2); Optional */
+	ST7735S_CMD_GAMSET, 1, 0x04, 0,
+	
+	/* Display on; The display driver does not need a wait */
+	ST7735S_CMD_DISPON, 0, 0
+};
+
+/*
+ * Send the steps of the command sequence and wait after them.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ *   step - The first step.
+ *   length - The size of the sequence in bytes.
+ */
+static void sendSequence(lcdst_t *display, const uint8 *step,
+						 unsigned int length)
+{
+	const uint8 *end = step + length;
+	uint8 i;
+	
+	while(step < end)
+	{
+		writeCommand(display, step[0]);
+		for(i = 0; i < step[1]; i++) writeData(display, step[2 + i]);
+		step += 2 + step[1];
+		
+		/* The commands without the wait are sent together */
+		if(*step)
+		{
+			flushQueue(display);
+			waitFor(display, *step);
+		}
+		step++;
+	}
+	
+	flushQueue(display);
+} /* sendSequence */
+
+/*
+ * Set the memory access, the pixel format and the window of the display
+ * driver to the default configuration of the library and activate it.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ */
+static void configureDisplay(lcdst_t *display)
+{
+	lcdst_setActiveDisplay(display);
+	display->panelValid = 0;
+	
+	lcdst_setOrientationOn(display, 0);
+	lcdst_setPixelFormatOn(display, ST7735S_CFG_PIXEL);
+} /* configureDisplay */
+
+/*
+ * Create the display and start the display driver, or take over
+ * the display driver which is already running.
+ */
+static lcdst_t *openDisplay(const lcdst_backend_t *backend, void *context,
+							int bus, uint8 attach)
+{
+	lcdst_t *instance;
+	
+	if((backend == NULL) || (backend->setDC == NULL)) return NULL;
+	if((backend->transfer == NULL) && (backend->transferv == NULL))
+		return NULL;
+	
+	/* Create the one instance of the lcdst_t structure */
+	instance = createDisplay(backend, context, bus);
+	
+	if(attach)
+	{
+		/* The image stays; Only the scrolling of the last owner ends */
+		writeCommand(instance, ST7735S_CMD_NORON);
+		flushQueue(instance);
+	}
+	else sendSequence(instance, startSequence, sizeof(startSequence));
+	
+	configureDisplay(instance);
+	return instance;
+} /* openDisplay */
+
+lcdst_t *lcdst_initBus(const lcdst_backend_t *backend, void *context, int bus)
+{
+	return openDisplay(backend, context, bus, 0);
+} /* lcdst_initBus */
+
+lcdst_t *lcdst_initBackend(const lcdst_backend_t *backend, void *context)
+{
+	return lcdst_initBus(backend, context, -1);
+} /* lcdst_initBackend */
+
+lcdst_t *lcdst_attachBus(const lcdst_backend_t *backend, void *context,
+						 int bus)
+{
+	return openDisplay(backend, context, bus, 1);
+} /* lcdst_attachBus */
+
+void lcdst_uninit(lcdst_t *display)
+{
+	if(display == NULL) return;
+	
+	/* Send the submitted frames and the pending data; Optional reset */
+	stopAsync(display);
+	flushQueue(display);
+	lcdst_hardwareReset(display);
+	
+	lcdst_detach(display);
+} /* lcdst_uninit */
+
+void lcdst_detach(lcdst_t *display)
+{
+	if(display == NULL) return;
+	
+	/* Send the submitted frames and the pending data */
+	stopAsync(display);
+	stopRender(display);
+	flushQueue(display);
+	
+	/* Release the backend; Free memory blocks */
+	if(display->backend->close != NULL)
+		display->backend->close(display->context);
+	if(display == activeDisplay) activeDisplay = NULL;
+	leaveBus(display->bus);
+	free(display->framebuffer);
+	free(display->ditherRow);
+	free(display->ditherError);
+	free(display->tileHashes);
+	free(display->fillChunk);
+	free(display->segments);
+	free(display->txBuffer);
+	free(display);
+} /* lcdst_detach */
+
+void lcdst_hardwareReset(lcdst_t *display)
+{
+	const lcdst_backend_t *backend = display->backend;
+	
+	/* If the reset pin is not connected, exit function */
+	if((backend->reset == NULL) || backend->reset(display->context, 1))
+		return;
+	
+	/* Apply reset; The pulse must be at least 10us */
+	if(backend->reset(display->context, 0)) return; /* Reset ON */
+	waitFor(display, 1);
+	backend->reset(display->context, 1); /* Reset OFF*/
+	
+	/* The running display (Sleep Out) needs 120ms to the next command */
+	waitFor(display, 120);
+	display->panelValid = 0;
+	display->streaming = 0;
+	display->tilesValid = 0;
+} /* lcdst_hardwareReset */
+
+uint8 lcdst_setChunkSizeOn(lcdst_t *display, unsigned int size)
+{
+	uint8 *buffer;
+	
+	if(size < 6) return 1;
+	
+	/* Send the pending data and replace the buffer */
+	flushQueue(display);
+	buffer = (uint8 *) realloc(display->txBuffer, size);
+	if(buffer == NULL) return 1;
+	
+	display->txBuffer = buffer;
+	display->txSize = size;
+	
+	/* The fill chunk has the same limit */
+	return allocFillChunk(display, size);
+} /* lcdst_setChunkSizeOn */
+
+uint8 lcdst_sendBufferOn(lcdst_t *display)
+{
+	endPixels(display);
+	flushQueue(display);
+	return takeError(display);
+} /* lcdst_sendBufferOn */
+
+void lcdst_setActiveDisplay(lcdst_t *display)
+{
+	activeDisplay = display;
+} /* lcdst_setActiveDisplay */
+
+lcdst_t *lcdst_getActiveDisplay(void)
+{
+	return activeDisplay;
+} /* lcdst_getActiveDisplay */
+
+uint8 lcdst_getWidthOn(lcdst_t *display)
+{
+	return display->width;
+} /* lcdst_getWidthOn */
+
+uint8 lcdst_getHeightOn(lcdst_t *display)
+{
+	return display->height;
+} /* lcdst_getHeightOn */
+
+/*
+ * Send the scrolling definition and the scroll start address of the active
+ * display. The logical areas are mapped to the frame memory rows. In the
+ * orientations 2 and 3 (MY) the memory rows are reversed, so the logical
+ * top area is at the bottom of the memory and the direction is opposite.
+ */
+static void sendScroll(lcdst_t *display)
+{
+	unsigned int tfa, bfa, ssa;
+	
+	if(display->orientation >= 2)
+	{
+		tfa = display->scrollBottom;
+		bfa = display->scrollTop + (GRAM_ROWS - PANEL_ROWS);
+		ssa = tfa + (display->scrollArea - display->scrollPos) % display->scrollArea;
+	}
+	else
+	{
+		tfa = display->scrollTop;
+		bfa = display->scrollBottom + (GRAM_ROWS - PANEL_ROWS);
+		ssa = tfa + display->scrollPos;
+	}
+	
+	/* Vertical Scrolling Definition */
+	writeCommand(display, ST7735S_CMD_VSCRDEF);
+	writeData(display, tfa >> 8);
+	writeData(display, tfa);
+	writeData(display, display->scrollArea >> 8);
+	writeData(display, display->scrollArea);
+	writeData(display, bfa >> 8);
+	writeData(display, bfa);
+	
+	/* Vertical Scroll Start Address */
+	writeCommand(display, ST7735S_CMD_VSCSAD);
+	writeData(display, ssa >> 8);
+	writeData(display, ssa);
+	flushQueue(display);
+} /* sendScroll */
+
+void lcdst_setOrientationOn(lcdst_t *display, uint8 orientation)
+{
+	/* The window and the whole frame must be sent in the new orientation */
+	display->panelValid = 0;
+	display->tilesValid = 0;
+	writeCommand(display, ST7735S_CMD_MADCTL);
+	
+	switch(orientation)
+	{
+		case 1:
+			writeData(display, 0x60); /* MX + MV */
+			display->width  = 160;
+			display->height = 128;
+			lcdst_setWindowOn(display, 0, 0, 159, 127);
+			break;
+	
+		case 2:
+			writeData(display, 0xC0); /* MY + MX */
+			display->width  = 128;
+			display->height = 160;
+			lcdst_setWindowOn(display, 0, 0, 127, 159);
+			break;
+	
+		case 3:
+			writeData(display, 0xA0); /* MY + MV */
+			display->width  = 160;
+			display->height = 128;
+			lcdst_setWindowOn(display, 0, 0, 159, 127);
+			break;
+	
+		default:
+			writeData(display, 0x00); /* None */
+			display->width  = 128;
+			display->height = 160;
+			lcdst_setWindowOn(display, 0, 0, 127, 159);
+			break;
+	}
+	
+	/* The scroll axis can be reversed in the new orientation */
+	display->orientation = orientation > 3 ? 0 : orientation;
+	if(display->scrollArea != 0) sendScroll(display);
+	
+	/* The framebuffer has the new layout; Send all of it */
+	if(display->framebuffer != NULL)
+	{
+		display->dirtyCount = 0;
+		markDirty(display, 0, 0, display->width - 1, display->height - 1);
+	}
+	
+	flushQueue(display);
+} /* lcdst_setOrientationOn */
+
+uint8 lcdst_setPixelFormatOn(lcdst_t *display, uint8 pixel)
+{
+	uint8 colmod;
+	
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_FULL:    colmod = 0x06; break; /* 18-bit */
+		case ST7735S_PIXEL_MEDIUM:  colmod = 0x05; break; /* 16-bit */
+		case ST7735S_PIXEL_REDUCED: colmod = 0x03; break; /* 12-bit */
+		default: return 1;
+	}
+	
+	/* Interface pixel format */
+	writeCommand(display, ST7735S_CMD_COLMOD);
+	writeData(display, colmod);
+	flushQueue(display);
+	display->pixel = pixel;
+	
+	/* The framebuffer must be sent again in the new format */
+	if(display->framebuffer != NULL)
+	{
+		display->dirtyCount = 0;
+		markDirty(display, 0, 0, display->width - 1, display->height - 1);
+	}
+	
+	return 0;
+} /* lcdst_setPixelFormatOn */
+
+uint8 lcdst_getPixelFormatOn(lcdst_t *display)
+{
+	return display->pixel;
+} /* lcdst_getPixelFormatOn */
+
+uint8 lcdst_setDitherOn(lcdst_t *display, uint8 mode)
+{
+	if(mode > ST7735S_DITHER_DIFFUSION) return 1;
+	
+	display->dither = mode;
+	return 0;
+} /* lcdst_setDitherOn */
+
+uint8 lcdst_setScrollAreaOn(lcdst_t *display, uint8 top, uint8 bottom)
+{
+	/* The scroll area must have at least one line */
+	if(top + bottom >= PANEL_ROWS) return 1;
+	
+	display->scrollTop = top;
+	display->scrollBottom = bottom;
+	display->scrollPos = 0;
+	
+	/* Without the fixed areas return to the normal display mode */
+	if((top == 0) && (bottom == 0))
+	{
+		display->scrollArea = 0;
+		writeCommand(display, ST7735S_CMD_NORON);
+		flushQueue(display);
+		return 0;
+	}
+	
+	display->scrollArea = PANEL_ROWS - top - bottom;
+	sendScroll(display);
+	
+	return 0;
+} /* lcdst_setScrollAreaOn */
+
+uint8 lcdst_scrollMapOn(lcdst_t *display, uint8 line)
+{
+	/* The fixed areas are not moved */
+	if((display->scrollArea == 0) || (line < display->scrollTop)
+	|| (line >= display->scrollTop + display->scrollArea)) return line;
+	
+	return display->scrollTop + (line - display->scrollTop
+		+ display->scrollPos) % display->scrollArea;
+} /* lcdst_scrollMapOn */
+
+uint8 lcdst_scrollOn(lcdst_t *display, uint8 lines, uint8 r, uint8 g, uint8 b)
+{
+	unsigned int end, first, length;
+	
+	if(display->scrollArea == 0) return 1;
+	if(lines > display->scrollArea) lines = display->scrollArea;
+	
+	/* Move the content toward the top area */
+	display->scrollPos = (display->scrollPos + lines) % display->scrollArea;
+	sendScroll(display);
+	
+	/* Clear the exposed band; It can wrap to the start of the scroll area */
+	end = display->scrollTop + display->scrollArea;
+	first = lcdst_scrollMapOn(display, end - lines);
+	length = end - first < lines ? end - first : lines;
+	
+	if(display->orientation & 1)
+	{
+		lcdst_drawFRectOn(display, first, 0, length, display->height, r, g, b);
+		if(length < lines)
+			lcdst_drawFRectOn(display, display->scrollTop, 0, lines - length,
+							  display->height, r, g, b);
+	}
+	else
+	{
+		lcdst_drawFRectOn(display, 0, first, display->width, length, r, g, b);
+		if(length < lines)
+			lcdst_drawFRectOn(display, 0, display->scrollTop, display->width,
+							  lines - length, r, g, b);
+	}
+	
+	return 0;
+} /* lcdst_scrollOn */
+
+void lcdst_setGammaOn(lcdst_t *display, uint8 state)
+{
+	/* The status (0 or 1) of the GS pin can only be empirically tested */
+	switch(state)
+	{
+		case 1:  state = 2; break; /* GS_pin=1: 1.8; GS_pin=0: 2.5 */
+		case 2:  state = 4; break; /* GS_pin=1: 2.5; GS_pin=0: 2.2 */
+		case 3:  state = 8; break; /* GS_pin=1: 1.0; GS_pin=0: 1.8 */
+		default: state = 1; break; /* GS_pin=1: 2.2; GS_pin=0: 1.0 */
+	}
+	
+	/* Set built-in gamma */
+	writeCommand(display, ST7735S_CMD_GAMSET);
+	writeData(display, state);
+	flushQueue(display);
+} /* lcdst_setGammaOn */
+
+void lcdst_setInversionOn(lcdst_t *display, uint8 state)
+{
+	/* Display inversion ON/OFF */
+	writeCommand(display, state ? ST7735S_CMD_INVON : ST7735S_CMD_INVOFF);
+	flushQueue(display);
+} /* lcdst_setInversionOn */
+
+/*
+ * Send the commands, which set the drawing area, to the display driver.
+ * The coordinates must be correct.
+ */
+static void sendWindow(lcdst_t *display,
+					   uint8 x1, uint8 y1, uint8 x2, uint8 y2)
+{
+	lcdst_rect_t *panel = &display->panel;
+	uint8 column, row;
+	
+	/* Compare with the addresses which the display driver already has */
+	column = !(display->panelValid & 1) || (panel->x1 != x1) || (panel->x2 != x2);
+	row    = !(display->panelValid & 2) || (panel->y1 != y1) || (panel->y2 != y2);
+	
+	/* The write cursor is already at the start of the window */
+	if(!column && !row && display->streaming && (display->streamCount == 0))
+		return;
+	
+	/* Set column address */
+	if(column)
+	{
+		writeCommand(display, ST7735S_CMD_CASET);
+		writeData(display, 0); writeData(display, x1);
+		writeData(display, 0); writeData(display, x2);
+		panel->x1 = x1; panel->x2 = x2;
+	}
+	
+	/* Set row address */
+	if(row)
+	{
+		writeCommand(display, ST7735S_CMD_RASET);
+		writeData(display, 0); writeData(display, y1);
+		writeData(display, 0); writeData(display, y2);
+		panel->y1 = y1; panel->y2 = y2;
+	}
+	
+#if ST7735S_CFG_STATS
+	if(column || row) display->stats.windows++;
+#endif
+	
+	/* Activate RAW write */
+	display->panelValid = 3;
+	writeCommand(display, ST7735S_CMD_RAMWR);
+} /* sendWindow */
+
+/*
+ * Check if the write cursor of the display driver is at the pixel,
+ * so the pixel can be sent without setting the window.
+ *
+ * Return: 1 - The pixel continues the stream; 0 - It does not.
+ */
+static uint8 atCursor(lcdst_t *display, uint8 x, uint8 y)
+{
+	lcdst_rect_t *panel = &display->panel;
+	unsigned long width, index;
+	
+	if(!display->streaming) return 0;
+	
+	/* The cursor wraps inside the window, like in the display driver */
+	width = panel->x2 - panel->x1 + 1;
+	index = display->streamCount % (width * (panel->y2 - panel->y1 + 1));
+	
+	return (x == panel->x1 + index % width) && (y == panel->y1 + index / width);
+} /* atCursor */
+
+uint8 lcdst_setWindowOn(lcdst_t *display,
+						uint8 x1, uint8 y1, uint8 x2, uint8 y2)
+{
+	lcdst_rect_t *window = &display->window;
+	
+	/* Accept: 0 <= x1 <= x2 < display->width */
+	if(x2 < x1) return 1;
+	if(x2 >= display->width) return 1;
+	
+	/* Accept: 0 <= y1 <= y2 < display->height */
+	if(y2 < y1) return 1;
+	if(y2 >= display->height) return 1;
+	
+	/* Remember the window for the framebuffer */
+	window->x1 = x1; window->y1 = y1;
+	window->x2 = x2; window->y2 = y2;
+	display->cursorX = x1;
+	display->cursorY = y1;
+	
+	if(display->framebuffer != NULL)
+	{
+		/* The pixels pushed to the window will be sent by lcdst_flush() */
+		markDirty(display, x1, y1, x2, y2);
+		return 0;
+	}
+	
+	sendWindow(display, x1, y1, x2, y2);
+	return 0;
+} /* lcdst_setWindowOn */
+
+void lcdst_activateRamWriteOn(lcdst_t *display)
+{
+	display->cursorX = display->window.x1;
+	display->cursorY = display->window.y1;
+	if(display->framebuffer != NULL) return;
+	
+	writeCommand(display, ST7735S_CMD_RAMWR);
+} /* lcdst_activateRamWriteOn */
+
+/*
+ * Fill the rectangle in the framebuffer and mark it as dirty.
+ * The coordinates must be inside the display space.
+ */
+static void fbFill(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+				   uint8 r, uint8 g, uint8 b)
+{
+	unsigned int stride = display->width * 3;
+	uint8 *first = display->framebuffer + (size_t) y * stride + x * 3;
+	uint8 *row = first, *px = first;
+	unsigned int i;
+	
+	/* Fill the first row and copy it to the others */
+	for(i = 0; i < w; i++, px += 3) {px[0] = r; px[1] = g; px[2] = b;}
+	for(i = 1; i < h; i++) memcpy(row += stride, first, w * 3);
+	
+	markDirty(display, x, y, x+w-1, y+h-1);
+} /* fbFill */
+
+/*
+ * Write the pixel to the framebuffer at the write cursor
+ * and move the cursor inside the window, like the display driver does.
+ */
+static void fbPush(lcdst_t *display, uint8 r, uint8 g, uint8 b)
+{
+	uint8 *px = display->framebuffer
+			  + ((size_t) display->cursorY * display->width + display->cursorX) * 3;
+	
+	px[0] = r; px[1] = g; px[2] = b;
+	
+	if(display->cursorX++ < display->window.x2) return;
+	display->cursorX = display->window.x1;
+	if(display->cursorY++ < display->window.y2) return;
+	display->cursorY = display->window.y1;
+} /* fbPush */
+
+/*
+ * Draw the rectangle in the framebuffer, if the active display has one.
+ * The rectangle must be already clipped to the display space
+ * at the right and bottom side.
+ *
+ * Return: 1 - The drawing was handled; 0 - There is no framebuffer.
+ */
+static uint8 fbDraw(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					uint8 r, uint8 g, uint8 b)
+{
+	if(display->framebuffer == NULL) return 0;
+	
+	if((x < display->width) && (y < display->height))
+		fbFill(display, x, y, w, h, r, g, b);
+	
+	return 1;
+} /* fbDraw */
+
+/*
+ * Send the raw pixel color in the pixel format of the active display.
+ * In the reduced format two pixels share three bytes. The first byte
+ * is sent at once and the half of the second byte waits for the next pixel.
+ */
+static inline void writePixel(lcdst_t *display, uint8 r, uint8 g, uint8 b)
+{
+	display->streamCount++;
+	switch(display->pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:
+			writeData(display, (r & 0xF8) | (g >> 5));
+			writeData(display, ((g << 3) & 0xE0) | (b >> 3));
+			break;
+		
+		case ST7735S_PIXEL_REDUCED:
+			if(display->halfPending)
+			{
+				writeData(display, display->half | (r >> 4));
+				writeData(display, (g & 0xF0) | (b >> 4));
+				display->halfPending = 0;
+			}
+			else
+			{
+				writeData(display, (r & 0xF0) | (g >> 4));
+				display->half = b & 0xF0;
+				display->halfPending = 1;
+			}
+			break;
+		
+		default:
+			writeData(display, r); writeData(display, g); writeData(display, b);
+			break;
+	}
+} /* writePixel */
+
+/*
+ * End the stream of the pixels. In the reduced format the waiting half
+ * of the last pixel is sent.
+ */
+static inline void endPixels(lcdst_t *display)
+{
+	if(!display->halfPending) return;
+	
+	display->halfPending = 0;
+	writeData(display, display->half);
+	
+	/* The half of the next pixel is already sent; The stream is broken */
+	display->streaming = 0;
+} /* endPixels */
+
+/*
+ * Send the pixels of one color to the window of the active display.
+ * The encoded pattern is replicated in the fill chunk once and the chunk
+ * is streamed repeatedly. The pixel stream must start with a whole pixel.
+ *
+ * Parameters:
+ *   count - The number of pixels.
+ *   r, g, b - The raw pixel color.
+ */
+static void fillPixels(lcdst_t *display, unsigned long count,
+					   uint8 r, uint8 g, uint8 b)
+{
+	uint8 *chunk = display->fillChunk;
+	unsigned long bytes;
+	unsigned int unit, size;
+	
+	/* The size of the pattern and of the whole stream */
+	switch(display->pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  unit = 2; bytes = count * 2; break;
+		case ST7735S_PIXEL_REDUCED: unit = 3; bytes = (count * 3 + 1) / 2; break;
+		default:                    unit = 3; bytes = count * 3; break;
+	}
+	
+	/* Prepare the pattern, if the chunk has a different one */
+	if(!display->fillValid || (display->fillPixel != display->pixel)
+	|| (display->fillColor[0] != r) || (display->fillColor[1] != g)
+	|| (display->fillColor[2] != b))
+	{
+		/* The chunk can be still queued for sending */
+		flushQueue(display);
+		
+		switch(display->pixel)
+		{
+			case ST7735S_PIXEL_MEDIUM:
+				chunk[0] = (r & 0xF8) | (g >> 5);
+				chunk[1] = ((g << 3) & 0xE0) | (b >> 3);
+				break;
+			
+			case ST7735S_PIXEL_REDUCED:
+				chunk[0] = (r & 0xF0) | (g >> 4);
+				chunk[1] = (b & 0xF0) | (r >> 4);
+				chunk[2] = (g & 0xF0) | (b >> 4);
+				break;
+			
+			default:
+				chunk[0] = r; chunk[1] = g; chunk[2] = b;
+				break;
+		}
+		
+		/* Replicate the pattern by doubling it */
+		for(size = unit; size < display->fillSize; size *= 2)
+			memcpy(chunk + size, chunk,
+				   size * 2 <= display->fillSize ? size : display->fillSize - size);
+		
+		display->fillPixel = display->pixel;
+		display->fillColor[0] = r;
+		display->fillColor[1] = g;
+		display->fillColor[2] = b;
+		display->fillValid = 1;
+	}
+	
+	/* Stream the whole chunks and the tail */
+	display->streamCount += count;
+	
+	/* The odd reduced pixels end in the half byte; The stream is broken */
+	if((display->pixel == ST7735S_PIXEL_REDUCED) && (count & 1))
+		display->streaming = 0;
+	for(; bytes > display->fillSize; bytes -= display->fillSize)
+		queueData(display, chunk, display->fillSize);
+	queueData(display, chunk, bytes);
+} /* fillPixels */
+
+/*
+ * Convert the row of the source pixels directly into the transmit buffer.
+ * In the reduced format the single pixels at the ends of the row
+ * are paired with the neighbouring rows by writePixel(display).
+ */
+static void blitRow(lcdst_t *display, lcdst_convert_t convert,
+					const uint8 *src, unsigned int count, uint8 srcFormat)
+{
+	lcdst_convert_t single = lcdst_getConverter(srcFormat, ST7735S_PIXEL_FULL);
+	unsigned int srcSize = lcdst_getSourceSize(srcFormat);
+	unsigned int n, space, unit, pairs = display->pixel == ST7735S_PIXEL_REDUCED;
+	uint8 px[3];
+	
+	/* The bytes per pixel; In the reduced format per two pixels */
+	unit = (display->pixel == ST7735S_PIXEL_MEDIUM) ? 2 : 3;
+	
+	/* Complete the pair started in the previous row */
+	if(display->halfPending && count)
+	{
+		single(px, src, 1);
+		writePixel(display, px[0], px[1], px[2]);
+		src += srcSize;
+		count--;
+	}
+	
+	while(count > pairs)
+	{
+		/* The number of pixels which fit in the buffer */
+		space = display->txSize - display->txLength;
+		if(space < unit) {flushQueue(display); continue;}
+		n = (space / unit) << pairs;
+		if(n > count) n = count >> pairs << pairs;
+		
+		convert(reserveData(display, (n >> pairs) * unit), src, n);
+		display->streamCount += n;
+		src += n * srcSize;
+		count -= n;
+	}
+	
+	/* The last single pixel of the reduced format */
+	if(count)
+	{
+		single(px, src, 1);
+		writePixel(display, px[0], px[1], px[2]);
+	}
+} /* blitRow */
+
+/*
+ * Send the row of the source pixels with the dithering of the display.
+ * The row is converted to RGB888 in the row buffer and dithered there,
+ * then it is converted to the pixel size like without the dithering.
+ *
+ * Parameters:
+ *   x, y - The position of the first pixel on the display.
+ */
+static void sendRow(lcdst_t *display, lcdst_convert_t convert,
+					const uint8 *src, unsigned int count, uint8 srcFormat,
+					uint8 x, uint8 y)
+{
+	uint8 *row = display->ditherRow;
+	
+	if((display->dither == ST7735S_DITHER_NONE)
+	|| (display->pixel == ST7735S_PIXEL_FULL))
+	{
+		blitRow(display, convert, src, count, srcFormat);
+		return;
+	}
+	
+	lcdst_getConverter(srcFormat, ST7735S_PIXEL_FULL)(row, src, count);
+	if(display->dither == ST7735S_DITHER_ORDERED)
+		lcdst_ditherOrdered(row, count, display->pixel, x, y);
+	else
+		lcdst_ditherDiffusion(row, count, display->pixel, display->ditherError);
+	
+	blitRow(display, lcdst_getConverter(ST7735S_SRC_RGB888, display->pixel),
+			row, count, ST7735S_SRC_RGB888);
+} /* sendRow */
+
+/*
+ * Start the error diffusion of the new bitmap.
+ */
+static inline void resetDither(lcdst_t *display, unsigned int count)
+{
+	if(display->dither == ST7735S_DITHER_DIFFUSION)
+		memset(display->ditherError, 0, (count + 2) * 3 * sizeof(short));
+} /* resetDither */
+
+/*
+ * Send the rectangle of the framebuffer to the display driver.
+ * The rows are converted like the RGB888 bitmap and dithered;
+ * In the reduced format the pixels are paired across the rows.
+ */
+static void sendRect(lcdst_t *display, const lcdst_rect_t *rect)
+{
+	lcdst_convert_t convert =
+		lcdst_getConverter(ST7735S_SRC_RGB888, display->pixel);
+	unsigned int w = rect->x2 - rect->x1 + 1;
+	const uint8 *row = display->framebuffer
+		+ ((size_t) rect->y1 * display->width + rect->x1) * 3;
+	uint8 y;
+	
+	sendWindow(display, rect->x1, rect->y1, rect->x2, rect->y2);
+	resetDither(display, w);
+	for(y = rect->y1; y <= rect->y2; y++, row += display->width * 3)
+		sendRow(display, convert, row, w, ST7735S_SRC_RGB888, rect->x1, y);
+	endPixels(display);
+} /* sendRect */
+
+/*
+ * Draw the bitmap like lcdst_blitOn(display), but leave the pixels
+ * in the transmit queue.
+ */
+static uint8 blitRect(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					  const void *src, unsigned int stride, uint8 srcFormat)
+{
+	lcdst_convert_t convert = lcdst_getConverter(srcFormat, display->pixel);
+	unsigned int srcSize = lcdst_getSourceSize(srcFormat);
+	const uint8 *row = (const uint8 *) src;
+	uint8 *fb;
+	
+	if((convert == NULL) || (src == NULL)) return 1;
+	
+	/* The packed rows have the width of the whole bitmap */
+	if(stride == 0) stride = w * srcSize;
+	
+	/* Draw only in the display space */
+	if((w == 0) || (h == 0)) return 0;
+	if((x >= display->width) || (y >= display->height)) return 1;
+	if((x+w-1) >= display->width)  w = display->width  - x;
+	if((y+h-1) >= display->height) h = display->height - y;
+	
+	/* Convert the rows to the framebuffer */
+	if(display->framebuffer != NULL)
+	{
+		markDirty(display, x, y, x+w-1, y+h-1);
+		convert = lcdst_getConverter(srcFormat, ST7735S_PIXEL_FULL);
+		fb = display->framebuffer + ((size_t) y * display->width + x) * 3;
+		for(; h; h--, row += stride, fb += display->width * 3)
+			convert(fb, row, w);
+		return 0;
+	}
+	
+	/* Send the rows */
+	if(lcdst_setWindowOn(display, x, y, x+w-1, y+h-1)) return 1;
+	resetDither(display, w);
+	for(; h; h--, y++, row += stride)
+		sendRow(display, convert, row, w, srcFormat, x, y);
+	endPixels(display);
+	
+	return 0;
+} /* blitRect */
+
+uint8 lcdst_blitOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+				   const void *src, unsigned int stride, uint8 srcFormat)
+{
+	if(blitRect(display, x, y, w, h, src, stride, srcFormat)) return 1;
+	flushQueue(display);
+	
+	return 0;
+} /* lcdst_blitOn */
+
+/*
+ * Hash the tile of the frame with the 64-bit multiply and rotate mix.
+ * The rows are read in words of 8 bytes; The end of the row is padded
+ * with zeros.
+ *
+ * Parameters:
+ *   src - Pointer to the first pixel of the tile.
+ *   stride - The distance between the rows in bytes.
+ *   length - The length of the row of the tile in bytes.
+ *   rows - The height of the tile.
+ *
+ * Return: The hash of the tile.
+ */
+static unsigned long long hashTile(const uint8 *src, unsigned int stride,
+								   unsigned int length, unsigned int rows)
+{
+	unsigned long long hash = 0x9E3779B97F4A7C15ULL, word;
+	unsigned int i;
+	
+	for(; rows; rows--, src += stride)
+	{
+		for(i = 0; i + 8 <= length; i += 8)
+		{
+			memcpy(&word, src + i, 8);
+			hash ^= word * 0xC2B2AE3D27D4EB4FULL;
+			hash = ((hash << 31) | (hash >> 33)) * 0x9E3779B97F4A7C15ULL;
+		}
+		
+		word = 0;
+		memcpy(&word, src + i, length - i);
+		hash ^= word * 0xC2B2AE3D27D4EB4FULL;
+		hash = ((hash << 31) | (hash >> 33)) * 0x9E3779B97F4A7C15ULL;
+	}
+	
+	return hash;
+} /* hashTile */
+
+uint8 lcdst_pushFrameOn(lcdst_t *display, const void *frame,
+						unsigned int stride, uint8 srcFormat)
+{
+	unsigned int srcSize = lcdst_getSourceSize(srcFormat);
+	unsigned int tw = display->tileWidth, th = display->tileHeight;
+	unsigned int columns, rows, column, row, x, y, w, h, i = 0, tiles = 0;
+	unsigned long tilePixels = 0, framePixels = 0;
+	unsigned long long hash, start = clockNs();
+	lcdst_rect_t rects[ST7735S_CFG_DIRTY + 1], rect;
+	const uint8 *src = (const uint8 *) frame;
+	uint8 count = 0;
+	
+	if((srcSize == 0) || (frame == NULL)) return 1;
+	if(stride == 0) stride = display->width * srcSize;
+	
+	/* The hashes have the place for the tiles of every orientation */
+	columns = (PANEL_ROWS + tw - 1) / tw;
+	rows = (PANEL_ROWS + th - 1) / th;
+	if(display->tileHashes == NULL)
+	{
+		display->tileHashes = (unsigned long long *)
+			safeMalloc(columns * rows * sizeof(unsigned long long));
+		display->tilesValid = 0;
+	}
+	
+	/* Compare the tiles with the previous frame */
+	columns = (display->width + tw - 1) / tw;
+	rows = (display->height + th - 1) / th;
+	for(row = 0, y = 0; row < rows; row++, y += th)
+	{
+		h = display->height - y < th ? display->height - y : th;
+		for(column = 0, x = 0; column < columns; column++, x += tw, i++)
+		{
+			w = display->width - x < tw ? display->width - x : tw;
+			hash = hashTile(src + (size_t) y * stride + x * srcSize, stride,
+							w * srcSize, h);
+			if(display->tilesValid && (display->tileHashes[i] == hash))
+				continue;
+			
+			display->tileHashes[i] = hash;
+			rect.x1 = x; rect.y1 = y; rect.x2 = x+w-1; rect.y2 = y+h-1;
+			mergeRect(rects, &count, rect);
+			tiles++;
+			tilePixels += w * h;
+		}
+	}
+	display->tilesValid = 1;
+	
+	for(i = 0; i < count; i++) framePixels += rectArea(&rects[i]);
+	countFrame(display, tiles, tilePixels, framePixels, start);
+	
+	/* Draw the merged rectangles */
+	for(i = 0; i < count; i++)
+	{
+		rect = rects[i];
+		lcdst_blitOn(display, rect.x1, rect.y1, rect.x2 - rect.x1 + 1,
+					 rect.y2 - rect.y1 + 1, src + (size_t) rect.y1 * stride
+					 + rect.x1 * srcSize, stride, srcFormat);
+	}
+	
+	return 0;
+} /* lcdst_pushFrameOn */
+
+uint8 lcdst_setFrameTilesOn(lcdst_t *display, uint8 w, uint8 h)
+{
+	if((w == 0) || (h == 0) || (w > PANEL_ROWS) || (h > PANEL_ROWS)) return 1;
+	
+	/* The hashes are allocated again for the new grid */
+	free(display->tileHashes);
+	display->tileHashes = NULL;
+	display->tilesValid = 0;
+	display->tileWidth = w;
+	display->tileHeight = h;
+	
+	return 0;
+} /* lcdst_setFrameTilesOn */
+
+/*
+ * Advance the pixel stream by the encoded bytes.
+ * The reduced format has 2 pixels in 3 bytes; After an odd pixel
+ * the half of the next pixel is already sent and the stream is broken.
+ */
+static inline void countEncoded(lcdst_t *display, unsigned int length)
+{
+	switch(display->pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  display->streamCount += length / 2; break;
+		case ST7735S_PIXEL_REDUCED:
+			display->streamCount += length * 2 / 3;
+			if(length % 3) display->streaming = 0;
+			break;
+		
+		default:                    display->streamCount += length / 3; break;
+	}
+} /* countEncoded */
+
+uint8 lcdst_pushEncodedOn(lcdst_t *display,
+						  const uint8 *data, unsigned int length)
+{
+	unsigned int n, unit;
+	
+	if(display->framebuffer != NULL) return 1;
+	if(display->halfPending) return 1;
+	
+	countEncoded(display, length);
+	
+	/* Copy the bytes in pieces, which fit in the transmit buffer */
+	unit = display->txSize;
+	for(; length; length -= n, data += n)
+	{
+		n = (length < unit) ? length : unit;
+		memcpy(reserveData(display, n), data, n);
+	}
+	
+	return 0;
+} /* lcdst_pushEncodedOn */
+
+uint8 lcdst_queueEncodedOn(lcdst_t *display,
+						   const uint8 *data, unsigned int length)
+{
+	if(display->framebuffer != NULL) return 1;
+	if(display->halfPending) return 1;
+	
+	countEncoded(display, length);
+	
+	/* The segment refers to the caller's memory; No copy is made */
+	queueData(display, data, length);
+	
+	return 0;
+} /* lcdst_queueEncodedOn */
+
+void lcdst_pushPxOn(lcdst_t *display, uint8 r, uint8 g, uint8 b)
+{
+	if(display->framebuffer != NULL) {fbPush(display, r, g, b); return;}
+	writePixel(display, r, g, b);
+} /* lcdst_pushPxOn */
+
+void lcdst_pushRPxOn(lcdst_t *display, uint8 r, uint8 g, uint8 b,
+					 uint8 rr, uint8 gg, uint8 bb)
+{
+	lcdst_pushPxOn(display, r, g, b);
+	lcdst_pushPxOn(display, rr, gg, bb);
+} /* lcdst_pushRPxOn */
+
+void lcdst_drawPxOn(lcdst_t *display, uint8 x, uint8 y,
+					uint8 r, uint8 g, uint8 b)
+{
+	if(fbDraw(display, x, y, 1, 1, r, g, b)) return;
+	
+	/*
+	 * The window ends at the right edge, so the next pixel of the row
+	 * continues the stream and the pixels of the column share CASET.
+	 */
+	if(!atCursor(display, x, y)
+	&& lcdst_setWindowOn(display, x, y, display->width-1, y)) return;
+	writePixel(display, r, g, b);
+	endPixels(display);
+	flushQueue(display);
+} /* lcdst_drawPxOn */
+
+void lcdst_drawHLineOn(lcdst_t *display, uint8 x, uint8 y, uint8 l,
+					   uint8 r, uint8 g, uint8 b)
+{
+	/* Draw only in the display space */
+	if(l == 0) return;
+	if((x+l-1) >= display->width) l = display->width - x;
+	
+	/* Draw the line */
+	if(fbDraw(display, x, y, l, 1, r, g, b)) return;
+	if(lcdst_setWindowOn(display, x, y, x+l-1, y)) return;
+	fillPixels(display, l, r, g, b);
+	flushQueue(display);
+} /* lcdst_drawHLineOn */
+
+void lcdst_drawVLineOn(lcdst_t *display, uint8 x, uint8 y, uint8 l,
+					   uint8 r, uint8 g, uint8 b)
+{
+	/* Draw only in the display space */
+	if(l == 0) return;
+	if((y+l-1) >= display->height) l = display->height - y;
+	
+	/* Draw the line */
+	if(fbDraw(display, x, y, 1, l, r, g, b)) return;
+	if(lcdst_setWindowOn(display, x, y, x, y+l-1)) return;
+	fillPixels(display, l, r, g, b);
+	flushQueue(display);
+} /* lcdst_drawVLineOn */
+
+void lcdst_drawFRectOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					   uint8 r, uint8 g, uint8 b)
+{
+	/* Draw only in the display space */
+	if((w == 0) || (h == 0)) return;
+	if((x+w-1) >= display->width)  w = display->width  - x;
+	if((y+h-1) >= display->height) h = display->height - y;
+	
+	/* Draw the filed rectangle */
+	if(fbDraw(display, x, y, w, h, r, g, b)) return;
+	if(lcdst_setWindowOn(display, x, y, x+w-1, y+h-1)) return;
+	fillPixels(display, (unsigned long) w * h, r, g, b);
+	flushQueue(display);
+} /* lcdst_drawFRectOn */
+
+uint8 lcdst_setFramebufferOn(lcdst_t *display, uint8 state)
 {
-	void (* const delay)(unsigned int milliseconds);
-	void (* const pinMode)(int pin, int mode);
-	void (* const digitalWrite)(int pin, int value);
-	int  (* const spiSetup)(int channel, int speed);
-	int  (* const spiDataRW)(int channel, uint8 *data, int length);
-} static const gpio =
+	size_t size = (size_t) display->width * display->height * 3;
+	
+	if(!state)
+	{
+		/* Send the last changes and draw directly again */
+		if(display->framebuffer == NULL) return 0;
+		stopAsync(display);
+		lcdst_flushOn(display);
+		free(display->framebuffer);
+		display->framebuffer = NULL;
+		sendWindow(display, display->window.x1, display->window.y1,
+				   display->window.x2, display->window.y2);
+		flushQueue(display);
+		return 0;
+	}
+	
+	if(display->framebuffer != NULL) return 0;
+	
+	/* The content of the display is unknown, so it starts black */
+	display->framebuffer = (uint8 *) calloc(size, 1);
+	if(display->framebuffer == NULL) return 1;
+	display->dirtyCount = 0;
+	display->tilesValid = 0;
+	markDirty(display, 0, 0, display->width - 1, display->height - 1);
+	
+	return 0;
+} /* lcdst_setFramebufferOn */
+
+void lcdst_markDirtyOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h)
+{
+	/* Mark only in the display space */
+	if((display->framebuffer == NULL) || (w == 0) || (h == 0)) return;
+	if((x >= display->width) || (y >= display->height)) return;
+	if((x+w-1) >= display->width)  w = display->width  - x;
+	if((y+h-1) >= display->height) h = display->height - y;
+	
+	markDirty(display, x, y, x+w-1, y+h-1);
+} /* lcdst_markDirtyOn */
+
+uint8 lcdst_flushOn(lcdst_t *display)
+{
+	uint8 i;
+	
+	if(display->framebuffer == NULL) return takeError(display);
+	
+	for(i = 0; i < display->dirtyCount; i++) sendRect(display, &display->dirty[i]);
+	display->dirtyCount = 0;
+	flushQueue(display);
+	return takeError(display);
+} /* lcdst_flushOn */
+
+/*
+ * Wait until the transmit thread has at most the specified number
+ * of frames to send.
+ */
+static void asyncWait(lcdst_t *display, unsigned int pending)
+{
+	struct lcdst_async *async = display->async;
+	unsigned int head = atomic_load_explicit(&async->head, memory_order_relaxed);
+	
+	/* Every sent frame posts 'done'; Check the count again after each */
+	while(head - atomic_load_explicit(&async->tail, memory_order_acquire)
+		  > pending)
+		while(sem_wait(&async->done) == -1 && errno == EINTR);
+} /* asyncWait */
+
+/*
+ * The transmit thread of the asynchronous mode. It sends the frames
+ * from the ring until it is woken up without a frame.
+ *
+ * Parameters:
+ *   arg - Pointer to the structure with display data.
+ */
+static void *asyncThread(void *arg)
+{
+	struct lcdst_async *async = ((lcdst_t *) arg)->async;
+	lcdst_t *sender = &async->sender;
+	const uint64_t one = 1;
+	unsigned int tail;
+	frame_t *frame;
+	uint8 i;
+	
+	for(;;)
+	{
+		while(sem_wait(&async->work) == -1 && errno == EINTR);
+		
+		tail = atomic_load_explicit(&async->tail, memory_order_relaxed);
+		if(tail == atomic_load_explicit(&async->head, memory_order_acquire))
+			break;
+		frame = async->frames + tail % ASYNC_FRAMES;
+		
+		/* The drawing thread could send other windows in the meantime */
+		sender->framebuffer = frame->framebuffer;
+		sender->width = frame->width;
+		sender->height = frame->height;
+		sender->pixel = frame->pixel;
+		sender->dither = frame->dither;
+		sender->panelValid = 0;
+		sender->streaming = 0;
+		sender->dcLevel = 2;
+		for(i = 0; i < frame->dirtyCount; i++)
+			sendRect(sender, &frame->dirty[i]);
+		flushQueue(sender);
+		if(sender->sendError)
+		{
+			atomic_store_explicit(&async->error, 1, memory_order_relaxed);
+			sender->sendError = 0;
+		}
+		
+		/* The framebuffer of the frame is free again */
+		atomic_store_explicit(&async->tail, tail + 1, memory_order_release);
+		if(async->callback != NULL) async->callback(async->user);
+		if(write(async->event, &one, sizeof(one)) < 0) {/* Never full */}
+		sem_post(&async->done);
+	}
+	
+	return NULL;
+} /* asyncThread */
+
+/*
+ * Stop the transmit thread after the submitted frames and release
+ * the second framebuffer. The display keeps the framebuffer,
+ * which is drawn now.
+ */
+static void stopAsync(lcdst_t *display)
+{
+	struct lcdst_async *async = display->async;
+	
+	if(async == NULL) return;
+	
+	/* The wake up without a frame ends the thread */
+	asyncWait(display, 0);
+	sem_post(&async->work);
+	pthread_join(async->thread, NULL);
+	if(atomic_load_explicit(&async->error, memory_order_relaxed))
+		display->sendError = 1;
+#if ST7735S_CFG_STATS
+	addStats(&display->stats, &async->sender.stats);
+#endif
+	
+	free(async->buffers[async->buffers[0] == display->framebuffer]);
+	free(async->sender.txBuffer);
+	free(async->sender.segments);
+	free(async->sender.ditherRow);
+	free(async->sender.ditherError);
+	sem_destroy(&async->work);
+	sem_destroy(&async->done);
+	close(async->event);
+	free(async);
+	display->async = NULL;
+} /* stopAsync */
+
+uint8 lcdst_setAsyncOn(lcdst_t *display, uint8 state,
+					   lcdst_callback_t callback, void *user)
+{
+	size_t size = (size_t) display->width * display->height * 3;
+	struct lcdst_async *async;
+	
+	if(!state) {stopAsync(display); return 0;}
+	if(display->async != NULL) return 1;
+	if(lcdst_setFramebufferOn(display, 1)) return 1;
+	
+	async = (struct lcdst_async *) calloc(1, sizeof(struct lcdst_async));
+	if(async == NULL) return 1;
+	
+	/* The second framebuffer starts with the same content */
+	async->buffers[0] = display->framebuffer;
+	async->buffers[1] = (uint8 *) malloc(size);
+	if(async->buffers[1] == NULL) {free(async); return 1;}
+	memcpy(async->buffers[1], async->buffers[0], size);
+	
+	/* The thread has its own transmit queue on the same backend and bus */
+	async->sender.backend = display->backend;
+	async->sender.context = display->context;
+	async->sender.bus = display->bus;
+	async->sender.txSize = display->txSize;
+	async->sender.txBuffer = (uint8 *) safeMalloc(display->txSize);
+	async->sender.segSize = display->segSize;
+	async->sender.segments = (lcdst_segment_t *)
+		safeMalloc(display->segSize * sizeof(lcdst_segment_t));
+	allocDither(&async->sender);
+#if ST7735S_CFG_STATS
+	async->sender.trace = display->trace;
+	async->sender.traceUser = display->traceUser;
+#endif
+	
+	async->callback = callback;
+	async->user = user;
+	async->event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	atomic_init(&async->head, 0);
+	atomic_init(&async->tail, 0);
+	atomic_init(&async->error, 0);
+	sem_init(&async->work, 0, 0);
+	sem_init(&async->done, 0, 0);
+	
+	display->async = async;
+	if((async->event < 0)
+	|| pthread_create(&async->thread, NULL, asyncThread, display))
+	{
+		if(async->event >= 0) close(async->event);
+		display->async = NULL;
+		sem_destroy(&async->work);
+		sem_destroy(&async->done);
+		free(async->sender.ditherRow);
+		free(async->sender.ditherError);
+		free(async->sender.segments);
+		free(async->sender.txBuffer);
+		free(async->buffers[1]);
+		free(async);
+		return 1;
+	}
+	
+	return 0;
+} /* lcdst_setAsyncOn */
+
+uint8 lcdst_submitFrameOn(lcdst_t *display)
+{
+	struct lcdst_async *async = display->async;
+	unsigned int head, stride = display->width * 3, length;
+	lcdst_rect_t *rect;
+	frame_t *frame;
+	size_t offset;
+	uint8 *to, i, y;
+	
+	if(display->framebuffer == NULL) return 1;
+	if(async == NULL) return lcdst_flushOn(display);
+	
+	/* The pixels pushed to the window are not sent, like in lcdst_flush() */
+	head = atomic_load_explicit(&async->head, memory_order_relaxed);
+	frame = async->frames + head % ASYNC_FRAMES;
+	frame->framebuffer = display->framebuffer;
+	memcpy(frame->dirty, display->dirty, sizeof(frame->dirty));
+	frame->dirtyCount = display->dirtyCount;
+	frame->width = display->width;
+	frame->height = display->height;
+	frame->pixel = display->pixel;
+	frame->dither = display->dither;
+	
+	/* Hand the frame over; The thread changes the window and the D/C line */
+	atomic_store_explicit(&async->head, head + 1, memory_order_release);
+	sem_post(&async->work);
+	display->panelValid = 0;
+	display->streaming = 0;
+	display->dcLevel = 2;
+	
+	/* The other framebuffer is free after the previous frame */
+	asyncWait(display, 1);
+	to = async->buffers[async->buffers[0] == display->framebuffer];
+	
+	/* It has the previous frame; Copy the changes of this one */
+	for(i = 0; i < display->dirtyCount; i++)
+	{
+		rect = &display->dirty[i];
+		offset = (size_t) rect->y1 * stride + rect->x1 * 3;
+		length = (rect->x2 - rect->x1 + 1) * 3;
+		for(y = rect->y1; y <= rect->y2; y++, offset += stride)
+			memcpy(to + offset, display->framebuffer + offset, length);
+	}
+	
+	display->framebuffer = to;
+	display->dirtyCount = 0;
+	
+	return 0;
+} /* lcdst_submitFrameOn */
+
+uint8 lcdst_waitFramesOn(lcdst_t *display)
+{
+	if(display->async != NULL) asyncWait(display, 0);
+	return takeError(display);
+} /* lcdst_waitFramesOn */
+
+int lcdst_getFrameEventOn(lcdst_t *display)
 {
-	delay,
-	pinMode,
-	digitalWrite,
-	wiringPiSPISetup,
-	wiringPiSPIDataRW
-};
-/****************************** END EASY PORT END *****************************/
+	if(display->async == NULL) return -1;
+	return display->async->event;
+} /* lcdst_getFrameEventOn */
 
-/* The global variable that stores the pointer to the structure,
- * with the current active display.
+/*
+ * Get the number of bytes of the pixels in the pixel size.
+ * The reduced pixels are counted in pairs.
  */
-static lcdst_t *activeDisplay;
+static inline unsigned int encodedLength(uint8 pixel, unsigned int count)
+{
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  return count * 2;
+		case ST7735S_PIXEL_REDUCED: return count * 3 / 2;
+		default:                    return count * 3;
+	}
+} /* encodedLength */
 
 /*
- * Safe allocation of the memory block.
- *
- * Parameters:
- *   size - Size of memory block to allocate.
- *
- * Return:
- *   Pointer to the memory block. If an error occurs, stop the program.
+ * Render one band and convert it to the pixel size of the display.
+ * The mark of the band publishes its pixels to the sending thread.
  */
-static inline void *safeMalloc(size_t size)
+static void renderBand(struct lcdst_render *render, unsigned int band)
 {
-	void *memoryBlock = (void*) malloc(size);
-
-	/* Check the pointer */
-	if(memoryBlock == NULL)
+	unsigned int y = band * render->bandHeight, h = render->bandHeight, i;
+	uint8 *rows = render->rows + y * render->width * 3;
+	
+	if(y + h > render->height) h = render->height - y;
+	render->render(render->user, rows, y, render->width, h);
+	
+	if(render->convert != NULL)
 	{
-		fprintf(stderr, "Out of RAM memory!\n");
-		exit(EXIT_FAILURE);
+		if(render->dither != ST7735S_DITHER_NONE)
+			for(i = 0; i < h; i++)
+				lcdst_ditherOrdered(rows + i * render->width * 3,
+									render->width, render->pixel, 0, y + i);
+		
+		/* The whole rows; The reduced pixels are even in every orientation */
+		render->convert(render->encoded + encodedLength(render->pixel,
+						y * render->width), rows, h * render->width);
 	}
 	
-	return memoryBlock;
-} /* safeMalloc */
+	atomic_store_explicit(&render->ready[band], render->frame,
+						  memory_order_release);
+} /* renderBand */
 
 /*
- * Write the command to the display driver.
- *
- * Parameters:
- *   cmd - The command to write.
+ * The render thread. For every frame it takes the free bands until
+ * there are none and then reports that it is idle.
  */
-static inline void writeCommand(uint8 cmd)
+static void *renderThread(void *arg)
 {
-	gpio.digitalWrite(activeDisplay->a0, LOW);
-	gpio.spiDataRW(activeDisplay->cs, &cmd, 1);
-} /* writeCommand */
+	struct lcdst_render *render = (struct lcdst_render *) arg;
+	unsigned int band;
+	
+	for(;;)
+	{
+		while(sem_wait(&render->work) == -1 && errno == EINTR);
+		if(render->stop) return NULL;
+		
+		while((band = atomic_fetch_add_explicit(&render->next, 1,
+				memory_order_relaxed)) < render->bands)
+		{
+			renderBand(render, band);
+			sem_post(&render->done);
+		}
+		sem_post(&render->idle);
+	}
+} /* renderThread */
 
 /*
- * Write the data to the display driver.
- *
- * Parameters:
- *   data - The data to write.
+ * Stop the render threads and free them.
  */
-static inline void writeData(uint8 data)
+static void stopRender(lcdst_t *display)
 {
-	gpio.digitalWrite(activeDisplay->a0, HIGH);
-	gpio.spiDataRW(activeDisplay->cs, &data, 1);
-} /* writeData */
+	struct lcdst_render *render = display->render;
+	unsigned int i;
+	
+	if(render == NULL) return;
+	
+	render->stop = 1;
+	for(i = 0; i < render->count; i++) sem_post(&render->work);
+	for(i = 0; i < render->count; i++) pthread_join(render->threads[i], NULL);
+	
+	sem_destroy(&render->work);
+	sem_destroy(&render->done);
+	sem_destroy(&render->idle);
+	free(render->threads);
+	free(render->encoded);
+	free(render->rows);
+	free(render);
+	display->render = NULL;
+} /* stopRender */
 
-lcdst_t *lcdst_init(int spiSpeed, int cs, int a0, int rs)
+uint8 lcdst_setRenderThreadsOn(lcdst_t *display, unsigned int threads,
+							   uint8 bandHeight)
 {
-	/* Create the one instance of the lcdst_t structure and activate it */
-	lcdst_t *instance = (lcdst_t *) safeMalloc(sizeof(lcdst_t));
-	lcdst_setActiveDisplay(instance);
+	struct lcdst_render *render;
+	size_t size = (size_t) PANEL_ROWS * PANEL_ROWS * 3;
 	
-	/* Assign specific pins */
-	instance->cs = cs;
-	instance->a0 = a0;
-	instance->rs = rs;
-	/*
-	 * instance->width; instance->height
-	 * The setting of this variables will take place
-	 * in the function lcdst_setOrientation() below.
-	 */
+	stopRender(display);
+	
+	render = (struct lcdst_render *) safeMalloc(sizeof(struct lcdst_render));
+	render->bandHeight = bandHeight ? bandHeight : ST7735S_CFG_BAND;
+	render->frame = 0;
+	render->stop = 0;
+	render->rows = (uint8 *) safeMalloc(size);
+	render->encoded = (uint8 *) safeMalloc(size);
+	render->threads = (pthread_t *) safeMalloc((threads ? threads : 1)
+											   * sizeof(pthread_t));
+	for(render->count = 0; render->count < PANEL_ROWS; render->count++)
+		atomic_init(&render->ready[render->count], 0);
+	sem_init(&render->work, 0, 0);
+	sem_init(&render->done, 0, 0);
+	sem_init(&render->idle, 0, 0);
+	display->render = render;
+	
+	for(render->count = 0; render->count < threads; render->count++)
+		if(pthread_create(&render->threads[render->count], NULL,
+						  renderThread, render))
+		{
+			stopRender(display);
+			return 1;
+		}
+	
+	return 0;
+} /* lcdst_setRenderThreadsOn */
+
+uint8 lcdst_renderFrameOn(lcdst_t *display, lcdst_render_t render, void *user)
+{
+	struct lcdst_render *pool;
+	unsigned int band, taken, i, y, h;
+	uint8 result = 0;
+	
+	if(render == NULL) return 1;
+	if((display->render == NULL) && lcdst_setRenderThreadsOn(display, 0, 0))
+		return 1;
 	
-	/* Configure the a0 pin. The logic level is not significant now. */
-	gpio.pinMode(instance->a0, OUTPUT);
+	/* Describe the frame; The threads read it after the wake-up */
+	pool = display->render;
+	pool->render = render;
+	pool->user = user;
+	pool->width = display->width;
+	pool->height = display->height;
+	pool->pixel = display->pixel;
+	pool->dither = display->dither;
+	pool->convert = (display->framebuffer != NULL) ? NULL :
+		lcdst_getConverter(ST7735S_SRC_RGB888, display->pixel);
+	pool->bands = (pool->height + pool->bandHeight - 1) / pool->bandHeight;
+	pool->frame++;
+	atomic_store_explicit(&pool->next, 0, memory_order_relaxed);
+	for(i = 0; i < pool->count; i++) sem_post(&pool->work);
+	if(pool->convert != NULL) endPixels(display);
 	
-	/* If the rs pin is connected then configure it */
-	if(instance->rs != -1)
+	for(band = 0; band < pool->bands; band++)
 	{
-		gpio.pinMode(instance->rs, OUTPUT);
-		gpio.digitalWrite(instance->rs, HIGH); /* Reset OFF */
+		/* Render the free band while this one is not ready */
+		while(atomic_load_explicit(&pool->ready[band], memory_order_acquire)
+			  != pool->frame)
+		{
+			taken = atomic_fetch_add_explicit(&pool->next, 1,
+											  memory_order_relaxed);
+			if(taken < pool->bands) renderBand(pool, taken);
+			else while(sem_wait(&pool->done) == -1 && errno == EINTR);
+		}
+		
+		/* Send the band as one window */
+		y = band * pool->bandHeight;
+		h = (y + pool->bandHeight > pool->height) ? pool->height - y :
+			pool->bandHeight;
+		if(pool->convert == NULL)
+		{
+			result |= lcdst_blitOn(display, 0, y, pool->width, h,
+								   pool->rows + y * pool->width * 3, 0,
+								   ST7735S_SRC_RGB888);
+			continue;
+		}
+		
+		result |= lcdst_setWindowOn(display, 0, y, pool->width - 1, y + h - 1);
+		result |= lcdst_queueEncodedOn(display, pool->encoded + encodedLength(
+			pool->pixel, y * pool->width), encodedLength(pool->pixel,
+			h * pool->width));
+		flushQueue(display);
 	}
+	result |= takeError(display);
+	
+	/* The threads leave the frame before the next one is described */
+	for(i = 0; i < pool->count; i++)
+		while(sem_wait(&pool->idle) == -1 && errno == EINTR);
+	while(sem_trywait(&pool->done) == 0);
+	
+	return result;
+} /* lcdst_renderFrameOn */
+
+uint8 lcdst_getStatsOn(lcdst_t *display, lcdst_stats_t *stats)
+{
+#if ST7735S_CFG_STATS
+	*stats = display->stats;
 	
-	/* Configure the SPI interface */
-	if(gpio.spiSetup(instance->cs, spiSpeed) == -1)
+	/* The transmit thread is idle after the submitted frames */
+	if(display->async != NULL)
 	{
-		fprintf(stderr, "Failed to setup the SPI interface!\n");
-		exit(EXIT_FAILURE);
+		asyncWait(display, 0);
+		addStats(stats, &display->async->sender.stats);
 	}
 	
-	/* Software reset; Wait minimum 120ms */
-	writeCommand(0x01);
-	gpio.delay(150);
+	return 0;
+#else
+	(void) display;
+	memset(stats, 0, sizeof(lcdst_stats_t));
+	return 1;
+#endif
+} /* lcdst_getStatsOn */
+
+void lcdst_resetStatsOn(lcdst_t *display)
+{
+#if ST7735S_CFG_STATS
+	memset(&display->stats, 0, sizeof(display->stats));
+	if(display->async != NULL)
+	{
+		asyncWait(display, 0);
+		memset(&display->async->sender.stats, 0, sizeof(lcdst_stats_t));
+	}
+#else
+	(void) display;
+#endif
+} /* lcdst_resetStatsOn */
+
+void lcdst_setTraceOn(lcdst_t *display, lcdst_trace_t trace, void *user)
+{
+#if ST7735S_CFG_STATS
+	display->trace = trace;
+	display->traceUser = user;
+	if(display->async != NULL)
+	{
+		asyncWait(display, 0);
+		display->async->sender.trace = trace;
+		display->async->sender.traceUser = user;
+	}
+#else
+	(void) display; (void) trace; (void) user;
+#endif
+} /* lcdst_setTraceOn */
+
+void lcdst_drawRectOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					  uint8 r, uint8 g, uint8 b)
+{
+	/* Draw the rectangle */
+	if((w >= 3) && (h >= 3))
+	{
+		lcdst_drawHLineOn(display, x,     y,     w,   r, g, b);
+		lcdst_drawHLineOn(display, x,     y+h-1, w,   r, g, b);
+		lcdst_drawVLineOn(display, x,     y+1,   h-2, r, g, b);
+		lcdst_drawVLineOn(display, x+w-1, y+1,   h-2, r, g, b);
+		return;
+	}
 	
-	/* Sleep out; Wait minimum 120ms */
-	writeCommand(0x11);
-	gpio.delay(150);
+	/* Draw the other shapes */
+	lcdst_drawFRectOn(display, x, y, w, h, r, g, b);
+} /* lcdst_drawRectOn */
+
+void lcdst_drawScreenOn(lcdst_t *display, uint8 r, uint8 g, uint8 b)
+{
+	/* Fill the whole screen with one color */
+	lcdst_drawFRectOn(display, 0, 0, display->width, display->height, r, g, b);
+} /* lcdst_drawScreenOn */
+
+uint8 lcdst_setListRefsOn(lcdst_t *display, const lcdst_listref_t *refs,
+						  unsigned int count)
+{
+	if((count > 255) || ((refs == NULL) && count)) return 1;
 	
-	/* Set the orientation and the gamma */
-	lcdst_setOrientation(0);
-	lcdst_setGamma(2); /* Optional */
+	display->refs = refs;
+	display->refCount = count;
+	return 0;
+} /* lcdst_setListRefsOn */
+
+/*
+ * Write the pixels of one color at the write cursor for the display list.
+ * The stream can continue the previous pixels; In the reduced format
+ * the odd pixels at the ends are paired by writePixel(display).
+ */
+static void listFill(lcdst_t *display, unsigned long count,
+					 uint8 r, uint8 g, uint8 b)
+{
+	if(display->framebuffer != NULL)
+	{
+		for(; count; count--) fbPush(display, r, g, b);
+		return;
+	}
 	
-	/* Set the pixel format */
-	writeCommand(0x3A);
-	#if ST7735S_CFG_PIXEL == ST7735S_PIXEL_FULL
-		writeData(0x06);
-	#elif ST7735S_CFG_PIXEL == ST7735S_PIXEL_REDUCED
-		writeData(0x03);
-	#endif
+	if(display->halfPending && count) {writePixel(display, r, g, b); count--;}
+	if((display->pixel == ST7735S_PIXEL_REDUCED) && (count % 2))
+	{
+		writePixel(display, r, g, b);
+		count--;
+	}
+	if(count) fillPixels(display, count, r, g, b);
+} /* listFill */
+
+/*
+ * Write the source pixels at the write cursor for the display list.
+ * They are converted straight into the transmit buffer.
+ */
+static void listPixels(lcdst_t *display, const uint8 *src,
+					   unsigned int count, uint8 srcFormat)
+{
+	lcdst_convert_t single = lcdst_getConverter(srcFormat, ST7735S_PIXEL_FULL);
+	unsigned int srcSize = lcdst_getSourceSize(srcFormat);
+	uint8 px[3];
 	
-	/* Display ON; Wait 100ms before start */
-	writeCommand(0x29);
-	gpio.delay(100);
+	if(display->framebuffer == NULL)
+	{
+		blitRow(display, lcdst_getConverter(srcFormat, display->pixel),
+				src, count, srcFormat);
+		return;
+	}
 	
-	return instance;
-} /* lcdst_init */
+	for(; count; count--, src += srcSize)
+	{
+		single(px, src, 1);
+		fbPush(display, px[0], px[1], px[2]);
+	}
+} /* listPixels */
 
-void lcdst_uninit(lcdst_t *display)
+/*
+ * Find the object of the display list.
+ *
+ * Return: Pointer to the object; NULL if there is no such object.
+ */
+static const lcdst_listref_t *listRef(lcdst_t *display, uint8 index)
 {
-	if(display == NULL) return;
-	
-	/* Optional reset; Free memory block */
-	lcdst_hardwareReset(display);
-	free(display);
-} /* lcdst_uninit */
+	return (index < display->refCount) ? display->refs + index : NULL;
+} /* listRef */
 
-void lcdst_hardwareReset(lcdst_t *display)
+uint8 lcdst_executeOn(lcdst_t *display, const uint8 *list, unsigned int length)
 {
-	/* If the reset pin is not connected, exit function */
-	if(display->rs == -1) return;
-	
-	/* Apply reset */
-	gpio.digitalWrite(display->rs, HIGH); /* Reset OFF */
-	gpio.digitalWrite(display->rs, LOW);  /* Reset ON */
-	gpio.delay(10);  /* Wait to activate */
-	gpio.digitalWrite(display->rs, HIGH); /* Reset OFF*/
-	gpio.delay(150); /* Wait before use */
-} /* lcdst_hardwareReset */
+	const uint8 *end = list + length, *op;
+	const lcdst_listref_t *ref;
+	const lcdst_font_t *font;
+	unsigned long count;
+	unsigned int size;
+	char text[256];
+	uint8 result = 0;
+	
+	if((list == NULL) && length) return 1;
+	
+	while(!result && (list < end))
+	{
+		op = list;
+		size = end - op;
+		switch(op[0])
+		{
+			case ST7735S_OP_WINDOW:
+				if(size < 5) {result = 1; break;}
+				result = lcdst_setWindowOn(display, op[1], op[2], op[3], op[4]);
+				list += 5;
+				break;
+			
+			case ST7735S_OP_FILL:
+				if(size < 6) {result = 1; break;}
+				
+				/* The following runs of the same color are added */
+				count = op[1] | (op[2] << 8);
+				for(list += 6; (end - list >= 6) && (list[0] == ST7735S_OP_FILL)
+					&& !memcmp(list + 3, op + 3, 3); list += 6)
+					count += list[1] | (list[2] << 8);
+				listFill(display, count, op[3], op[4], op[5]);
+				break;
+			
+			case ST7735S_OP_PIXELS:
+				if((size < 4) || (lcdst_getSourceSize(op[1]) == 0))
+				{
+					result = 1;
+					break;
+				}
+				count = op[2] | (op[3] << 8);
+				if(size - 4 < count * lcdst_getSourceSize(op[1]))
+				{
+					result = 1;
+					break;
+				}
+				listPixels(display, op + 4, count, op[1]);
+				list += 4 + count * lcdst_getSourceSize(op[1]);
+				break;
+			
+			case ST7735S_OP_TEXT:
+				if((size < 11) || (size - 11 < op[10])) {result = 1; break;}
+				ref = listRef(display, op[3]);
+				font = (op[3] == ST7735S_REF_FONT6X8) ? &lcdst_font6x8
+					 : (ref != NULL) ? ref->font : NULL;
+				if(font == NULL) {result = 1; break;}
+				
+				/* The text is not terminated in the list */
+				memcpy(text, op + 11, op[10]);
+				text[op[10]] = '\0';
+				result = lcdst_drawTextOn(display, op[1], op[2], text, font,
+										  op[4], op[5], op[6],
+										  op[7], op[8], op[9]);
+				list += 11 + op[10];
+				break;
+			
+			case ST7735S_OP_BLIT:
+				if(size < 4) {result = 1; break;}
+				ref = listRef(display, op[3]);
+				if((ref == NULL) || (ref->src == NULL)) {result = 1; break;}
+				result = blitRect(display, op[1], op[2], ref->width, ref->height,
+								  ref->src, ref->stride, ref->srcFormat);
+				list += 4;
+				break;
+			
+			default:
+				result = 1;
+				break;
+		}
+	}
+	
+	/* The whole list is sent at once */
+	endPixels(display);
+	flushQueue(display);
+	
+	return result;
+} /* lcdst_executeOn */
 
-void lcdst_setActiveDisplay(lcdst_t *display)
+/*
+ * The functions of the currently active display.
+ */
+
+uint8 lcdst_setChunkSize(unsigned int size)
 {
-	activeDisplay = display;
-} /* lcdst_setActiveDisplay */
+	return lcdst_setChunkSizeOn(activeDisplay, size);
+} /* lcdst_setChunkSize */
 
-lcdst_t *lcdst_getActiveDisplay(void)
+uint8 lcdst_sendBuffer(void)
 {
-	return activeDisplay;
-} /* lcdst_getActiveDisplay */
+	return lcdst_sendBufferOn(activeDisplay);
+} /* lcdst_sendBuffer */
 
 uint8 lcdst_getWidth(void)
 {
-	return activeDisplay->width;
+	return lcdst_getWidthOn(activeDisplay);
 } /* lcdst_getWidth */
 
 uint8 lcdst_getHeight(void)
 {
-	return activeDisplay->height;
+	return lcdst_getHeightOn(activeDisplay);
 } /* lcdst_getHeight */
 
 void lcdst_setOrientation(uint8 orientation)
 {
-	writeCommand(0x36); /* Memory Data Access Control */
+	lcdst_setOrientationOn(activeDisplay, orientation);
+} /* lcdst_setOrientation */
 
-	switch(orientation)
-	{
-		case 1:
-			writeData(0x60); /* MX + MV */
-			activeDisplay->width  = 160;
-			activeDisplay->height = 128;
-			lcdst_setWindow(0, 0, 159, 127);
-			break;
+uint8 lcdst_setPixelFormat(uint8 pixel)
+{
+	return lcdst_setPixelFormatOn(activeDisplay, pixel);
+} /* lcdst_setPixelFormat */
 
-		case 2:
-			writeData(0xC0); /* MY + MX */
-			activeDisplay->width  = 128;
-			activeDisplay->height = 160;
-			lcdst_setWindow(0, 0, 127, 159);
-			break;
+uint8 lcdst_getPixelFormat(void)
+{
+	return lcdst_getPixelFormatOn(activeDisplay);
+} /* lcdst_getPixelFormat */
 
-		case 3:
-			writeData(0xA0); /* MY + MV */
-			activeDisplay->width  = 160;
-			activeDisplay->height = 128;
-			lcdst_setWindow(0, 0, 159, 127);
-			break;
+uint8 lcdst_setDither(uint8 mode)
+{
+	return lcdst_setDitherOn(activeDisplay, mode);
+} /* lcdst_setDither */
 
-		default:
-			writeData(0x00); /* None */
-			activeDisplay->width  = 128;
-			activeDisplay->height = 160;
-			lcdst_setWindow(0, 0, 127, 159);
-			break;
-	}
-} /* lcdst_setOrientation */
+uint8 lcdst_setScrollArea(uint8 top, uint8 bottom)
+{
+	return lcdst_setScrollAreaOn(activeDisplay, top, bottom);
+} /* lcdst_setScrollArea */
+
+uint8 lcdst_scrollMap(uint8 line)
+{
+	return lcdst_scrollMapOn(activeDisplay, line);
+} /* lcdst_scrollMap */
+
+uint8 lcdst_scroll(uint8 lines, uint8 r, uint8 g, uint8 b)
+{
+	return lcdst_scrollOn(activeDisplay, lines, r, g, b);
+} /* lcdst_scroll */
 
 void lcdst_setGamma(uint8 state)
 {
-	/* The status (0 or 1) of the GS pin can only be empirically tested */
-	switch(state)
-	{
-		case 1:  state = 2; break; /* GS_pin=1: 1.8; GS_pin=0: 2.5 */
-		case 2:  state = 4; break; /* GS_pin=1: 2.5; GS_pin=0: 2.2 */
-		case 3:  state = 8; break; /* GS_pin=1: 1.0; GS_pin=0: 1.8 */
-		default: state = 1; break; /* GS_pin=1: 2.2; GS_pin=0: 1.0 */
-	}
-	
-	/* Set built-in gamma */
-	writeCommand(0x26);
-	writeData(state);
+	lcdst_setGammaOn(activeDisplay, state);
 } /* lcdst_setGamma */
 
 void lcdst_setInversion(uint8 state)
 {
-	/* Display inversion ON/OFF */
-	writeCommand(state ? 0x21 : 0x20);
+	lcdst_setInversionOn(activeDisplay, state);
 } /* lcdst_setInversion */
 
 uint8 lcdst_setWindow(uint8 x1, uint8 y1, uint8 x2, uint8 y2)
 {
-	/* Accept: 0 <= x1 <= x2 < activeDisplay->width */
-	if(x2 < x1) return 1;
-	if(x2 >= activeDisplay->width) return 1;
-	
-	/* Accept: 0 <= y1 <= y2 < activeDisplay->height */
-	if(y2 < y1) return 1;
-	if(y2 >= activeDisplay->height) return 1;
-	
-	/* Set column address */
-	writeCommand(0x2A);
-	writeData(0); writeData(x1);
-	writeData(0); writeData(x2);
-	
-	/* Set row address */
-	writeCommand(0x2B);
-	writeData(0); writeData(y1);
-	writeData(0); writeData(y2);
-	
-	/* Activate RAW write */
-	writeCommand(0x2C);
-	
-	return 0;
+	return lcdst_setWindowOn(activeDisplay, x1, y1, x2, y2);
 } /* lcdst_setWindow */
 
 void lcdst_activateRamWrite(void)
 {
-	writeCommand(0x2C);
+	lcdst_activateRamWriteOn(activeDisplay);
 } /* lcdst_activateRamWrite */
 
-/***************************** ST7735S_PIXEL_FULL *****************************/
-#if ST7735S_CFG_PIXEL == ST7735S_PIXEL_FULL
+uint8 lcdst_blit(uint8 x, uint8 y, uint8 w, uint8 h,
+				 const void *src, unsigned int stride, uint8 srcFormat)
+{
+	return lcdst_blitOn(activeDisplay, x, y, w, h, src, stride, srcFormat);
+} /* lcdst_blit */
 
-void lcdst_pushPx(uint8 r, uint8 g, uint8 b)
+uint8 lcdst_pushFrame(const void *frame, unsigned int stride, uint8 srcFormat)
 {
-	writeData(r); writeData(g); writeData(b);
-} /* lcdst_pushPx */
+	return lcdst_pushFrameOn(activeDisplay, frame, stride, srcFormat);
+} /* lcdst_pushFrame */
 
-void lcdst_drawPx(uint8 x, uint8 y, uint8 r, uint8 g, uint8 b)
+uint8 lcdst_setFrameTiles(uint8 w, uint8 h)
 {
-	if(lcdst_setWindow(x, y, x, y)) return;
-	writeData(r); writeData(g); writeData(b);
-} /* lcdst_drawPx */
+	return lcdst_setFrameTilesOn(activeDisplay, w, h);
+} /* lcdst_setFrameTiles */
 
-void lcdst_drawHLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b)
+uint8 lcdst_setListRefs(const lcdst_listref_t *refs, unsigned int count)
 {
-	/* Draw only in the display space */
-	if(l == 0) return;
-	if((x+l-1) >= activeDisplay->width) l = activeDisplay->width - x;
-	
-	/* Draw the line */
-	if(lcdst_setWindow(x, y, x+l-1, y)) return;
-	while(l--) {writeData(r); writeData(g); writeData(b);}
-} /* lcdst_drawHLine */
+	return lcdst_setListRefsOn(activeDisplay, refs, count);
+} /* lcdst_setListRefs */
 
-void lcdst_drawVLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b)
+uint8 lcdst_execute(const uint8 *list, unsigned int length)
 {
-	/* Draw only in the display space */
-	if(l == 0) return;
-	if((y+l-1) >= activeDisplay->height) l = activeDisplay->height - y;
-	
-	/* Draw the line */
-	if(lcdst_setWindow(x, y, x, y+l-1)) return;
-	while(l--) {writeData(r); writeData(g); writeData(b);}
-} /* lcdst_drawVLine */
+	return lcdst_executeOn(activeDisplay, list, length);
+} /* lcdst_execute */
 
-void lcdst_drawFRect(uint8 x, uint8 y, uint8 w, uint8 h,
-					uint8 r, uint8 g, uint8 b)
+uint8 lcdst_pushEncoded(const uint8 *data, unsigned int length)
 {
-	/* Draw only in the display space */
-	if((w == 0) || (h == 0)) return;
-	if((x+w-1) >= activeDisplay->width)  w = activeDisplay->width  - x;
-	if((y+h-1) >= activeDisplay->height) h = activeDisplay->height - y;
-	
-	/* Draw the filed rectangle */
-	if(lcdst_setWindow(x, y, x+w-1, y+h-1)) return;
-	while(w--) while(h--) {writeData(r); writeData(g); writeData(b);}
-} /* lcdst_drawFRect */
+	return lcdst_pushEncodedOn(activeDisplay, data, length);
+} /* lcdst_pushEncoded */
 
-/**************************** ST7735S_PIXEL_REDUCED ***************************/
-#elif ST7735S_CFG_PIXEL == ST7735S_PIXEL_REDUCED
+uint8 lcdst_queueEncoded(const uint8 *data, unsigned int length)
+{
+	return lcdst_queueEncodedOn(activeDisplay, data, length);
+} /* lcdst_queueEncoded */
 
-/* Conversion union; The order in the 'raw' structure is important. */
-typedef union
+void lcdst_pushPx(uint8 r, uint8 g, uint8 b)
 {
-	struct {uint8 g:4, r:4, rr:4, b:4, bb:4, gg:4;} raw;
-	uint8 toSend[3];
-} lcdst_frpx;
+	lcdst_pushPxOn(activeDisplay, r, g, b);
+} /* lcdst_pushPx */
 
 void lcdst_pushRPx(uint8 r, uint8 g, uint8 b, uint8 rr, uint8 gg, uint8 bb)
 {
-	lcdst_frpx data;
-	
-	/* Prepare the first pixel */
-	data.raw.r = r & 0x0F;
-	data.raw.g = g & 0x0F;
-	data.raw.b = b & 0x0F;
-	
-	/* Prepare the second pixel */
-	data.raw.rr = rr & 0x0F;
-	data.raw.gg = gg & 0x0F;
-	data.raw.bb = bb & 0x0F;
-	
-	/* Send pixels */
-	writeData(data.toSend[0]);
-	writeData(data.toSend[1]);
-	writeData(data.toSend[2]);
+	lcdst_pushRPxOn(activeDisplay, r, g, b, rr, gg, bb);
 } /* lcdst_pushRPx */
 
 void lcdst_drawPx(uint8 x, uint8 y, uint8 r, uint8 g, uint8 b)
 {
-	lcdst_frpx data;
-	
-	/* Prepare the pixel */
-	data.raw.r = r & 0x0F;
-	data.raw.g = g & 0x0F;
-	data.raw.b = b & 0x0F;
-	
-	/* Send pixel */
-	if(lcdst_setWindow(x, y, x, y)) return;
-	writeData(data.toSend[0]);
-	writeData(data.toSend[1]);
+	lcdst_drawPxOn(activeDisplay, x, y, r, g, b);
 } /* lcdst_drawPx */
 
 void lcdst_drawHLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b)
 {
-	lcdst_frpx data;
-	
-	/* Draw only in the display space */
-	if(l == 0) return;
-	if((x+l-1) >= activeDisplay->width) l = activeDisplay->width - x;
-	
-	/* Prepare the pixels */
-	data.raw.rr = data.raw.r = r & 0x0F;
-	data.raw.gg = data.raw.g = g & 0x0F;
-	data.raw.bb = data.raw.b = b & 0x0F;
-	
-	/* Draw the line */
-	if(lcdst_setWindow(x, y, x+l-1, y)) return;
-	while(l--)
-	{
-		writeData(data.toSend[0]);
-		writeData(data.toSend[1]);
-		writeData(data.toSend[2]);
-	}
+	lcdst_drawHLineOn(activeDisplay, x, y, l, r, g, b);
 } /* lcdst_drawHLine */
 
 void lcdst_drawVLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b)
 {
-	lcdst_frpx data;
-	
-	/* Draw only in the display space */
-	if(l == 0) return;
-	if((y+l-1) >= activeDisplay->height) l = activeDisplay->height - y;
-	
-	/* Prepare the pixels */
-	data.raw.rr = data.raw.r = r & 0x0F;
-	data.raw.gg = data.raw.g = g & 0x0F;
-	data.raw.bb = data.raw.b = b & 0x0F;
-	
-	/* Draw the line */
-	if(lcdst_setWindow(x, y, x, y+l-1)) return;
-	while(l--)
-	{
-		writeData(data.toSend[0]);
-		writeData(data.toSend[1]);
-		writeData(data.toSend[2]);
-	}
+	lcdst_drawVLineOn(activeDisplay, x, y, l, r, g, b);
 } /* lcdst_drawVLine */
 
 void lcdst_drawFRect(uint8 x, uint8 y, uint8 w, uint8 h,
 					uint8 r, uint8 g, uint8 b)
 {
-	lcdst_frpx data;
-	
-	/* Draw only in the display space */
-	if((w == 0) || (h == 0)) return;
-	if((x+w-1) >= activeDisplay->width)  w = activeDisplay->width  - x;
-	if((y+h-1) >= activeDisplay->height) h = activeDisplay->height - y;
-	
-	/* Prepare the pixels */
-	data.raw.rr = data.raw.r = r & 0x0F;
-	data.raw.gg = data.raw.g = g & 0x0F;
-	data.raw.bb = data.raw.b = b & 0x0F;
-	
-	/* Draw the filed rectangle */
-	if(lcdst_setWindow(x, y, x+w-1, y+h-1)) return;
-	while(w--) while(h--)
-	{
-		writeData(data.toSend[0]);
-		writeData(data.toSend[1]);
-		writeData(data.toSend[2]);
-	}
+	lcdst_drawFRectOn(activeDisplay, x, y, w, h, r, g, b);
 } /* lcdst_drawFRect */
 
-#endif /* ST7735S_CFG_PIXEL */
+uint8 lcdst_setFramebuffer(uint8 state)
+{
+	return lcdst_setFramebufferOn(activeDisplay, state);
+} /* lcdst_setFramebuffer */
+
+void lcdst_markDirty(uint8 x, uint8 y, uint8 w, uint8 h)
+{
+	lcdst_markDirtyOn(activeDisplay, x, y, w, h);
+} /* lcdst_markDirty */
+
+uint8 lcdst_flush(void)
+{
+	return lcdst_flushOn(activeDisplay);
+} /* lcdst_flush */
+
+uint8 lcdst_setAsync(uint8 state, lcdst_callback_t callback, void *user)
+{
+	return lcdst_setAsyncOn(activeDisplay, state, callback, user);
+} /* lcdst_setAsync */
+
+uint8 lcdst_submitFrame(void)
+{
+	return lcdst_submitFrameOn(activeDisplay);
+} /* lcdst_submitFrame */
+
+uint8 lcdst_waitFrames(void)
+{
+	return lcdst_waitFramesOn(activeDisplay);
+} /* lcdst_waitFrames */
+
+int lcdst_getFrameEvent(void)
+{
+	return lcdst_getFrameEventOn(activeDisplay);
+} /* lcdst_getFrameEvent */
+
+uint8 lcdst_setRenderThreads(unsigned int threads, uint8 bandHeight)
+{
+	return lcdst_setRenderThreadsOn(activeDisplay, threads, bandHeight);
+} /* lcdst_setRenderThreads */
+
+uint8 lcdst_renderFrame(lcdst_render_t render, void *user)
+{
+	return lcdst_renderFrameOn(activeDisplay, render, user);
+} /* lcdst_renderFrame */
+
+uint8 lcdst_getStats(lcdst_stats_t *stats)
+{
+	return lcdst_getStatsOn(activeDisplay, stats);
+} /* lcdst_getStats */
+
+void lcdst_resetStats(void)
+{
+	lcdst_resetStatsOn(activeDisplay);
+} /* lcdst_resetStats */
+
+void lcdst_setTrace(lcdst_trace_t trace, void *user)
+{
+	lcdst_setTraceOn(activeDisplay, trace, user);
+} /* lcdst_setTrace */
 
 void lcdst_drawRect(uint8 x, uint8 y, uint8 w, uint8 h,
 					uint8 r, uint8 g, uint8 b)
 {
-	/* Draw the rectangle */
-	if((w >= 3) && (h >= 3))
-	{
-		lcdst_drawHLine(x,     y,     w,   r, g, b);
-		lcdst_drawHLine(x,     y+h-1, w,   r, g, b);
-		lcdst_drawVLine(x,     y+1,   h-2, r, g, b);
-		lcdst_drawVLine(x+w-1, y+1,   h-2, r, g, b);
-		return;
-	}
-	
-	/* Draw the other shapes */
-	lcdst_drawFRect(x, y, w, h, r, g, b);
+	lcdst_drawRectOn(activeDisplay, x, y, w, h, r, g, b);
 } /* lcdst_drawRect */
 
 void lcdst_drawScreen(uint8 r, uint8 g, uint8 b)
 {
-	/* Fill the whole screen with one color */
-	lcdst_drawFRect(0, 0, activeDisplay->width, activeDisplay->height, r, g, b);
+	lcdst_drawScreenOn(activeDisplay, r, g, b);
 } /* lcdst_drawScreen */
@@ -13,15 +13,105 @@ extern "C" {
 #endif
 
 /* Pixel sizes */
-#define ST7735S_PIXEL_FULL 1
-#define ST7735S_PIXEL_REDUCED 0
+#define ST7735S_PIXEL_FULL 1    /* 18-bit; 3 bytes per pixel */
+#define ST7735S_PIXEL_MEDIUM 2  /* 16-bit RGB565; 2 bytes per pixel */
+#define ST7735S_PIXEL_REDUCED 0 /* 12-bit; 3 bytes per 2 pixels */
+
+/* Source formats of the bitmaps */
+#define ST7735S_SRC_RGB888 0   /* 3 bytes: r, g, b */
+#define ST7735S_SRC_BGR888 1   /* 3 bytes: b, g, r */
+#define ST7735S_SRC_RGBA8888 2 /* 4 bytes: r, g, b, a; Alpha is ignored */
+#define ST7735S_SRC_RGB565 3   /* 16-bit little-endian value */
+
+/* Dithering of the bitmaps to the medium and reduced pixel sizes */
+#define ST7735S_DITHER_NONE 0      /* The intensities are truncated */
+#define ST7735S_DITHER_ORDERED 1   /* The 4x4 Bayer matrix */
+#define ST7735S_DITHER_DIFFUSION 2 /* The Floyd-Steinberg error diffusion */
+
+/*
+ * Opcodes of the display list, see lcdst_execute(). The parameters
+ * follow the opcode; The counts are 2 bytes long, little-endian.
+ */
+#define ST7735S_OP_WINDOW 0x01 /* x1, y1, x2, y2 */
+#define ST7735S_OP_FILL   0x02 /* count, r, g, b */
+#define ST7735S_OP_PIXELS 0x03 /* srcFormat, count, count pixels */
+#define ST7735S_OP_TEXT   0x04 /* x, y, ref, r, g, b, br, bg, bb, n, n chars */
+#define ST7735S_OP_BLIT   0x05 /* x, y, ref */
+
+/* The reference of the built-in font in ST7735S_OP_TEXT */
+#define ST7735S_REF_FONT6X8 0xFF
+
+/* Commands of the display driver used by the library */
+#define ST7735S_CMD_SWRESET 0x01 /* Software Reset */
+#define ST7735S_CMD_SLPIN   0x10 /* Sleep In */
+#define ST7735S_CMD_SLPOUT  0x11 /* Sleep Out */
+#define ST7735S_CMD_PTLON   0x12 /* Partial Display Mode On */
+#define ST7735S_CMD_NORON   0x13 /* Normal Display Mode On */
+#define ST7735S_CMD_INVOFF  0x20 /* Display Inversion Off */
+#define ST7735S_CMD_INVON   0x21 /* Display Inversion On */
+#define ST7735S_CMD_GAMSET  0x26 /* Gamma Set */
+#define ST7735S_CMD_DISPOFF 0x28 /* Display Off */
+#define ST7735S_CMD_DISPON  0x29 /* Display On */
+#define ST7735S_CMD_CASET   0x2A /* Column Address Set */
+#define ST7735S_CMD_RASET   0x2B /* Row Address Set */
+#define ST7735S_CMD_RAMWR   0x2C /* Memory Write */
+#define ST7735S_CMD_VSCRDEF 0x33 /* Vertical Scrolling Definition */
+#define ST7735S_CMD_MADCTL  0x36 /* Memory Data Access Control */
+#define ST7735S_CMD_VSCSAD  0x37 /* Vertical Scroll Start Address */
+#define ST7735S_CMD_IDMOFF  0x38 /* Idle Mode Off */
+#define ST7735S_CMD_IDMON   0x39 /* Idle Mode On */
+#define ST7735S_CMD_COLMOD  0x3A /* Interface Pixel Format */
 
 /*
- * This setting determines the number of bits per pixel.
+ * This setting determines the default number of bits per pixel.
  * Choose the above pixel size, enter it in the configuration.
  * Without change, default value are selected.
+ * It can be changed at runtime with the lcdst_setPixelFormat() function.
  ******************************** CONFIGURATION *******************************/
 #define ST7735S_CFG_PIXEL ST7735S_PIXEL_FULL
+/*
+ * The default size in bytes of the transmit buffer of one display.
+ * The data is sent to the display in pieces of this size, so it should not
+ * exceed the 'bufsiz' limit of the spidev kernel module (default 4096).
+ * It can be changed at runtime with the lcdst_setChunkSize() function.
+ */
+#define ST7735S_CFG_CHUNK 4096
+/*
+ * The maximum number of segments (runs of bytes with one D/C level)
+ * collected in the transmit queue before it is sent.
+ */
+#define ST7735S_CFG_SEGMENTS 64
+/*
+ * The maximum number of dirty rectangles remembered in the framebuffer mode.
+ * When more rectangles are changed, the closest ones are merged.
+ */
+#define ST7735S_CFG_DIRTY 8
+/*
+ * The default size of the tiles compared by lcdst_pushFrame().
+ * It can be changed at runtime with the lcdst_setFrameTiles() function.
+ */
+#define ST7735S_CFG_TILE 16
+/*
+ * The maximum number of glyphs kept in the glyph cache. Every entry holds
+ * one character already encoded in one pixel size for one color pair.
+ * When the cache is full, the least recently used glyph is dropped.
+ */
+#define ST7735S_CFG_GLYPHS 128
+/*
+ * The maximum number of the sprites of one compositor, see st7735s_compose.h.
+ */
+#define ST7735S_CFG_SPRITES 16
+/*
+ * The default height of the bands rendered by lcdst_renderFrame().
+ * It can be changed at runtime with the lcdst_setRenderThreads() function.
+ */
+#define ST7735S_CFG_BAND 16
+/*
+ * The performance counters of every display and the trace callback.
+ * They are updated once per sending of the transmit queue, not per byte.
+ * Set to 0 to remove them from the library.
+ */
+#define ST7735S_CFG_STATS 1
 /**************************** END CONFIGURATION END ***************************/
 
 /* Type simplification; The 8-bit unsigned integer */
@@ -29,15 +119,211 @@ extern "C" {
 #define uint8 unsigned char
 #endif
  
+/* One segment of the transmission; All bytes have the same D/C level */
+typedef struct
+{
+	const uint8 *data;
+	unsigned int length;
+	uint8 dc; /* 0 = command; 1 = data */
+} lcdst_segment_t;
+
+/*
+ * The transport backend of one display. The 'context' parameter is the
+ * pointer given to the lcdst_initBackend() function.
+ *
+ * transfer - Send the bytes through the SPI interface without reading.
+ *            Return 0 on success. Required if 'transferv' is NULL.
+ * transferv - Optional. Send the segments in the given order,
+ *             setting the D/C line before each of them. Return 0 on success.
+ * setDC - Set the level of the Data/Command line. Required. It is called
+ *         only when the level changes, unless 'transferv' is used.
+ * reset - Optional. Set the level of the reset line. Return 1 if the reset
+ *         line is not connected or can not be set, otherwise 0.
+ * delay - Optional. Wait the specified time.
+ * close - Optional. Release the context, called by lcdst_uninit()
+ *         and lcdst_detach().
+ */
+typedef struct
+{
+	int  (*transfer)(void *context, const uint8 *data, unsigned int length);
+	int  (*transferv)(void *context, const lcdst_segment_t *segments,
+					  unsigned int count);
+	void (*setDC)(void *context, int level);
+	int  (*reset)(void *context, int level);
+	void (*delay)(void *context, unsigned int milliseconds);
+	void (*close)(void *context);
+} lcdst_backend_t;
+
+/* The rectangle; The coordinates of the corners are inclusive */
+typedef struct
+{
+	uint8 x1, y1, x2, y2;
+} lcdst_rect_t;
+
+/*
+ * The bitmap font with the fixed character cell. The rows of every cell
+ * are padded to whole bytes and the most significant bit is the left pixel.
+ * The cells of the characters follow each other from the first one.
+ */
+typedef struct
+{
+	uint8 width, height;  /* The size of the character cell */
+	uint8 first;          /* The code of the first character */
+	unsigned int count;   /* The number of characters */
+	const uint8 *bitmap;  /* The cells of the characters */
+} lcdst_font_t;
+
+/*
+ * The object, which the display list refers to by its index: The bitmap
+ * drawn by ST7735S_OP_BLIT or the font of ST7735S_OP_TEXT.
+ */
+typedef struct
+{
+	const void *src;          /* The bitmap; NULL for the font */
+	unsigned int stride;      /* The distance between its rows; 0 = packed */
+	uint8 width, height;      /* The size of the bitmap */
+	uint8 srcFormat;          /* Its format; ST7735S_SRC_* */
+	const lcdst_font_t *font; /* The font; NULL for the bitmap */
+} lcdst_listref_t;
+
+/*
+ * The function called by the transmit thread, when the frame submitted
+ * in the asynchronous mode is sent. It runs in the transmit thread,
+ * so it must not call the functions of the library for the same display.
+ */
+typedef void (*lcdst_callback_t)(void *user);
+
+/*
+ * The function which renders one band of the frame for lcdst_renderFrame().
+ * It writes the RGB888 pixels of the rows from 'y' to 'y + height - 1'
+ * of the display to 'rows'; The rows are packed. It runs in the render
+ * threads at the same time for the different bands, so it must not call
+ * the functions of the library and it must not change the shared data.
+ */
+typedef void (*lcdst_render_t)(void *user, uint8 *rows, uint8 y,
+							   uint8 width, uint8 height);
+
+/*
+ * The number of the buckets of the latency histogram. The bucket 0 counts
+ * the sendings shorter than 1 microsecond, the bucket i counts the ones
+ * from 2^(i-1) to 2^i microseconds and the last one all longer.
+ */
+#define ST7735S_STATS_BUCKETS 16
+
+/* The performance counters of one display */
+typedef struct
+{
+	unsigned long long commands;    /* Command bytes */
+	unsigned long long dataBytes;   /* Data bytes */
+	unsigned long long transfers;   /* Calls of the backend transfers */
+	unsigned long long dcToggles;   /* Changes of the D/C line level */
+	unsigned long long windows;     /* Window setups (CASET and RASET) */
+	unsigned long long flushes;     /* Sendings of the transmit queue */
+	unsigned long long frames;      /* Frames given to lcdst_pushFrame() */
+	unsigned long long tiles;       /* Changed tiles of the frames */
+	unsigned long long tilePixels;  /* Pixels of the changed tiles */
+	unsigned long long framePixels; /* Pixels of the merged rectangles */
+	unsigned long long diffNs;      /* The time of the hashing and merging */
+	unsigned long long transportNs; /* The time inside the backend */
+	unsigned long long latency[ST7735S_STATS_BUCKETS]; /* Per sending */
+} lcdst_stats_t;
+
+/*
+ * The function called after every call of the backend transfer with the
+ * sent segments and the time of the call. In the asynchronous mode
+ * it is called by the transmit thread for the frames.
+ */
+typedef void (*lcdst_trace_t)(void *user, const lcdst_segment_t *segments,
+							  unsigned int count, unsigned long nanoseconds);
+
+/* The built-in font; 5x7 characters in the 6x8 cell; ASCII from 0x20 to 0x7E */
+extern const lcdst_font_t lcdst_font6x8;
+
 /* The data type for one display */
 typedef struct
 {
 	int cs, a0, rs;
 	uint8 width, height;
+
+	/* Pixel size; The half of the byte waiting in the reduced format */
+	uint8 pixel;
+	uint8 half, halfPending;
+
+	/* Transport backend */
+	const lcdst_backend_t *backend;
+	void *context;
+
+	/* Transmit queue; The collected bytes and segments waiting for sending */
+	uint8 *txBuffer;
+	unsigned int txLength, txSize;
+	lcdst_segment_t *segments;
+	unsigned int segCount, segSize;
+
+	/* The orientation; The scrolling areas on the scroll axis (logical) */
+	uint8 orientation;
+	uint8 scrollTop, scrollBottom, scrollArea, scrollPos;
+
+	/* The chunk with the replicated pattern of the last fill color */
+	uint8 *fillChunk;
+	unsigned int fillSize;
+	uint8 fillColor[3], fillPixel, fillValid;
+
+	/* The last window and the write cursor in it */
+	lcdst_rect_t window;
+	uint8 cursorX, cursorY;
+
+	/*
+	 * The shadow of the window in the display driver (bit 0 - columns valid;
+	 * bit 1 - rows valid) and the number of pixels written since RAMWR.
+	 */
+	lcdst_rect_t panel;
+	uint8 panelValid, streaming;
+	unsigned long streamCount;
+
+	/* Optional framebuffer; 3 bytes (r, g, b) per pixel; The changed areas */
+	uint8 *framebuffer;
+	lcdst_rect_t dirty[ST7735S_CFG_DIRTY + 1];
+	uint8 dirtyCount;
+
+	/* The transmit thread of the asynchronous mode; NULL if it is off */
+	struct lcdst_async *async;
+
+	/* The render threads of lcdst_renderFrame(); NULL before the first use */
+	struct lcdst_render *render;
+
+	/* The lock of the SPI bus, which the display shares with others */
+	struct lcdst_bus *bus;
+
+	/* The last level of the D/C line; 2 = unknown */
+	uint8 dcLevel;
+
+	/* 1 = A transfer failed since the error was last reported */
+	uint8 sendError;
+
+	/* The dithering; The RGB888 row and the errors of the diffusion */
+	uint8 dither;
+	uint8 *ditherRow;
+	short *ditherError;
+
+	/* The tiles of lcdst_pushFrame(); The hashes of the last frame */
+	uint8 tileWidth, tileHeight, tilesValid;
+	unsigned long long *tileHashes;
+
+	/* The objects of the display list; Not owned by the display */
+	const lcdst_listref_t *refs;
+	unsigned int refCount;
+
+#if ST7735S_CFG_STATS
+	/* The performance counters; The trace */
+	lcdst_stats_t stats;
+	lcdst_trace_t trace;
+	void *traceUser;
+#endif
 } lcdst_t;
 
 /*
  * Initialize the display and create a data structure for it.
+ * The display is connected through the Wiring Pi library.
  * The last initialized display is active.
  *
  * Parameters:
@@ -51,8 +337,77 @@ typedef struct
  */
 lcdst_t *lcdst_init(int spiSpeed, int cs, int a0, int rs);
 
+/*
+ * Take over the display connected through the Wiring Pi library, which
+ * was started by another process, without the reset and the waits.
+ * It works like lcdst_attachBus(). The last attached display is active.
+ *
+ * Parameters:
+ *   spiSpeed - Speed of the SPI interface.
+ *   cs - Chip selection pin.
+ *   a0 - Data/Command pin.
+ *   rs - Optional reset pin. If you do not use it, enter -1.
+ *
+ * Return: Pointer to the structure with display data.
+ *
+ */
+lcdst_t *lcdst_attach(int spiSpeed, int cs, int a0, int rs);
+
+/*
+ * Initialize the display connected through the specified backend
+ * and create a data structure for it.
+ * The last initialized display is active.
+ *
+ * Parameters:
+ *   backend - Pointer to the transport backend. It must remain valid
+ *             until the display is uninitialized.
+ *   context - The pointer passed to the backend functions.
+ *
+ * Return: Pointer to the structure with display data.
+ * NULL if the backend does not have the required functions.
+ *
+ */
+lcdst_t *lcdst_initBackend(const lcdst_backend_t *backend, void *context);
+
+/*
+ * Initialize the display connected through the specified backend
+ * on the shared SPI bus, like lcdst_initBackend(). The displays with the
+ * same bus number (on the different chip selects) send the data one
+ * after another. The displays on the different buses work in parallel.
+ *
+ * Parameters:
+ *   backend - Pointer to the transport backend.
+ *   context - The pointer passed to the backend functions.
+ *   bus - The number of the SPI bus; -1 = the bus is not shared.
+ *
+ * Return: Pointer to the structure with display data.
+ * NULL if the backend does not have the required functions.
+ *
+ */
+lcdst_t *lcdst_initBus(const lcdst_backend_t *backend, void *context, int bus);
+
+/*
+ * Take over the display, which was started by another process
+ * (for example before the restart of the service), without the reset.
+ * Only the memory access control, the pixel format and the window
+ * are set again, so the image stays and there is no wait.
+ * The last attached display is active.
+ *
+ * Parameters:
+ *   backend - Pointer to the transport backend.
+ *   context - The pointer passed to the backend functions.
+ *   bus - The number of the SPI bus; -1 = the bus is not shared.
+ *
+ * Return: Pointer to the structure with display data.
+ * NULL if the backend does not have the required functions.
+ *
+ */
+lcdst_t *lcdst_attachBus(const lcdst_backend_t *backend, void *context,
+						 int bus);
+
 /*
  * Reset the specified display and clear the previously assigned memory.
+ * The backend is closed.
  *
  * Parameters:
  *   display - Pointer to the structure with display data.
@@ -61,6 +416,18 @@ lcdst_t *lcdst_init(int spiSpeed, int cs, int a0, int rs);
  */
 void lcdst_uninit(lcdst_t *display);
 
+/*
+ * Clear the previously assigned memory of the specified display
+ * without the reset, so the image stays for the next owner.
+ * The backend is closed.
+ *
+ * Parameters:
+ *   display - Pointer to the structure with display data.
+ *
+ * Return: void
+ */
+void lcdst_detach(lcdst_t *display);
+
 /*
  * Perform a hardware reset on a specified display.
  *
@@ -71,6 +438,214 @@ void lcdst_uninit(lcdst_t *display);
  */
 void lcdst_hardwareReset(lcdst_t *display);
 
+/*
+ * Set the size of the transmit buffer of the currently active display.
+ * The commands and the data bytes are collected in this buffer and handed
+ * to the backend together, when the buffer fills, the drawing function ends
+ * or the lcdst_sendBuffer() function is called.
+ * The pending data is sent before the size changes.
+ *
+ * Parameters:
+ *   size - Size of the buffer in bytes. Must be at least 6,
+ *          the size of two pixels.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setChunkSize(unsigned int size);
+
+/*
+ * Send the data collected in the transmit buffer of the currently active
+ * display. The drawing functions do this automatically. Call it after
+ * the lcdst_pushPx() and lcdst_pushRPx() functions to show the pixels.
+ * In the reduced pixel size, the last odd pixel is completed.
+ * The failed transfers of the drawing functions are reported here too.
+ *
+ * Parameters: none
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The backend failed to send the data
+ * since the last report by this function, lcdst_flush() or
+ * lcdst_waitFrames().
+ *
+ */
+uint8 lcdst_sendBuffer(void);
+
+/*
+ * Turn on or off the framebuffer mode of the currently active display.
+ * In this mode the drawing functions and lcdst_pushPx() write to the memory
+ * and remember the changed areas. The lcdst_flush() function sends only
+ * these areas, merged into the smallest number of windows.
+ * Turning the mode off sends the last changes.
+ *
+ * Parameters:
+ *   state - Choose one: 0 = 0FF; 1 = ON.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setFramebuffer(uint8 state);
+
+/*
+ * Send the changed areas of the framebuffer of the currently active display.
+ * Without the framebuffer mode this function does nothing.
+ *
+ * Parameters: none
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The backend failed to send the data,
+ * like in lcdst_sendBuffer().
+ *
+ */
+uint8 lcdst_flush(void);
+
+/*
+ * Turn on or off the asynchronous mode of the currently active display.
+ * In this mode the frames are sent by the transmit thread. The framebuffer
+ * mode is turned on and the second framebuffer is created, so the next
+ * frame is drawn while the previous one is sent, see lcdst_submitFrame().
+ * The other functions, which send to the display, wait for the submitted
+ * frames first. Turning the mode off waits for them too.
+ *
+ * Parameters:
+ *   state - Choose one: 0 = 0FF; 1 = ON.
+ *   callback - Optional function called after every sent frame.
+ *   user - The parameter of the callback.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setAsync(uint8 state, lcdst_callback_t callback, void *user);
+
+/*
+ * Submit the frame drawn in the framebuffer of the currently active display.
+ * In the asynchronous mode the changed areas are handed to the transmit
+ * thread and the drawing continues in the other framebuffer, which receives
+ * the changes first. The function waits only if the previous frame is still
+ * being sent. Without the asynchronous mode it works like lcdst_flush().
+ *
+ * Parameters: none
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - There is no framebuffer, or without
+ * the asynchronous mode the backend failed to send the data.
+ *
+ */
+uint8 lcdst_submitFrame(void);
+
+/*
+ * Wait until all frames submitted to the currently active display are sent.
+ * Without the asynchronous mode this function does nothing.
+ *
+ * Parameters: none
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The backend failed to send the data,
+ * also in the transmit thread, like in lcdst_sendBuffer().
+ *
+ */
+uint8 lcdst_waitFrames(void);
+
+/*
+ * Get the event descriptor of the asynchronous mode of the currently active
+ * display, for poll() or select(). It becomes readable when a frame is sent;
+ * Reading 8 bytes returns the number of frames sent since the last reading.
+ * The descriptor is closed when the asynchronous mode is turned off.
+ *
+ * Parameters: none
+ * Return: The eventfd descriptor; -1 without the asynchronous mode.
+ *
+ */
+int lcdst_getFrameEvent(void);
+
+/*
+ * Set the render threads and the height of the bands of lcdst_renderFrame()
+ * on the currently active display. The calling thread renders too,
+ * so the number of the cores minus one uses the whole processor.
+ *
+ * Parameters:
+ *   threads - The number of the render threads; 0 = only the calling thread.
+ *   bandHeight - The height of the bands; 0 = ST7735S_CFG_BAND.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The threads can not be created.
+ *
+ */
+uint8 lcdst_setRenderThreads(unsigned int threads, uint8 bandHeight);
+
+/*
+ * Render the whole frame in the bands and send it to the currently active
+ * display. The render threads take the bands in the scan order; The free
+ * thread takes the next band, so the slow bands do not hold the others.
+ * The rendered bands are converted to the pixel size by the threads and
+ * the calling thread sends every band as one window as soon as it and
+ * the bands above it are ready, so the sending overlaps the rendering.
+ * The calling thread renders the next free band while it waits.
+ *
+ * The ordered dithering is done by the render threads; The diffusion
+ * needs the rows in order, so it is replaced by the ordered dithering.
+ * In the framebuffer mode the bands are written to the framebuffer
+ * and the frame is sent by lcdst_flush() or lcdst_submitFrame().
+ *
+ * Parameters:
+ *   render - The function which renders one band.
+ *   user - The first parameter of the function.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_renderFrame(lcdst_render_t render, void *user);
+
+/*
+ * Copy the performance counters of the currently active display.
+ * In the asynchronous mode it waits for the submitted frames first
+ * and adds the counters of the transmit thread.
+ *
+ * Parameters:
+ *   stats - Pointer to the structure for the counters.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The counters are not compiled in.
+ *
+ */
+uint8 lcdst_getStats(lcdst_stats_t *stats);
+
+/*
+ * Clear the performance counters of the currently active display.
+ *
+ * Parameters: none
+ * Return: void
+ */
+void lcdst_resetStats(void);
+
+/*
+ * Set the function called after every transfer of the currently active
+ * display. It runs with the SPI bus locked, so it should be short.
+ * Without the counters compiled in, the function is never called.
+ *
+ * Parameters:
+ *   trace - The function; NULL turns the tracing off.
+ *   user - The pointer passed to the function.
+ *
+ * Return: void
+ */
+void lcdst_setTrace(lcdst_trace_t trace, void *user);
+
+/*
+ * Mark the rectangle of the framebuffer of the currently active display
+ * as changed. Use it after writing to the framebuffer memory directly.
+ * Without the framebuffer mode this function does nothing.
+ *
+ * Parameters:
+ *   x - Parameter X of the upper left corner of the rectangle.
+ *   y - Parameter Y of the upper left corner of the rectangle.
+ *   w - The width of the rectangle.
+ *   h - The height of the rectangle.
+ *
+ * Return: void
+ */
+void lcdst_markDirty(uint8 x, uint8 y, uint8 w, uint8 h);
+
 /*
  * Set the pointer to structure with the display data as active.
  *
@@ -119,6 +694,97 @@ uint8 lcdst_getHeight(void);
  */
 void lcdst_setOrientation(uint8 orientation);
 
+/*
+ * Set the pixel size of the currently active display.
+ * The color intensity scale is from 0 to 255 for every pixel size;
+ * The lower pixel sizes use the upper bits of the intensities.
+ *
+ * Parameters:
+ *   pixel - Choose one: ST7735S_PIXEL_FULL, ST7735S_PIXEL_MEDIUM
+ *           or ST7735S_PIXEL_REDUCED.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setPixelFormat(uint8 pixel);
+
+/*
+ * Get the pixel size of the currently active display.
+ *
+ * Parameters: none
+ * Return: ST7735S_PIXEL_FULL, ST7735S_PIXEL_MEDIUM or ST7735S_PIXEL_REDUCED.
+ *
+ */
+uint8 lcdst_getPixelFormat(void);
+
+/*
+ * Set the dithering of the bitmaps on the currently active display.
+ * The bitmaps (and the framebuffer, when it is sent) are converted to RGB888
+ * row by row and dithered to the levels of the medium or reduced pixel size
+ * before the conversion to the pixel size. It hides the bands of the smooth
+ * gradients, which the truncation of the intensities makes.
+ * The full pixel size and the solid colors are never dithered.
+ *
+ * Parameters:
+ *   mode - Choose one: ST7735S_DITHER_NONE, ST7735S_DITHER_ORDERED
+ *          or ST7735S_DITHER_DIFFUSION.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setDither(uint8 mode);
+
+/*
+ * Define the hardware scrolling areas of the currently active display.
+ * The scroll axis is Y in the orientations 0 and 2 and X in the orientations
+ * 1 and 3. The fixed areas are at the start and at the end of the axis.
+ * The definition is kept correct after lcdst_setOrientation().
+ * Enter 0 for both areas to return to the normal display mode.
+ *
+ * Parameters:
+ *   top - The number of fixed lines at the start of the scroll axis.
+ *   bottom - The number of fixed lines at the end of the scroll axis.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setScrollArea(uint8 top, uint8 bottom);
+
+/*
+ * Scroll the content of the scroll area of the currently active display
+ * toward the start of the scroll axis. Only a few command bytes are sent
+ * and the exposed band at the end of the area is filled with one color.
+ * The color intensity scale is from 0 to 255 for every pixel size.
+ *
+ * Parameters:
+ *   lines - The number of lines to scroll.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_scroll(uint8 lines, uint8 r, uint8 g, uint8 b);
+
+/*
+ * Translate the visible line of the currently active display to the line,
+ * which must be drawn to appear there. Use it for the coordinate on the
+ * scroll axis, to draw into the scrolled area, for example the new text row
+ * after lcdst_scroll(). The lines of the fixed areas are not changed.
+ *
+ * Parameters:
+ *   line - The visible line on the scroll axis.
+ *
+ * Return: The line to draw.
+ *
+ */
+uint8 lcdst_scrollMap(uint8 line);
+
 /*
  * Set the gamma correction for the currently active display.
  *
@@ -141,6 +807,7 @@ void lcdst_setInversion(uint8 state);
 
 /*
  * Set the drawing area on the currently active display.
+ * The commands are queued and sent together with the following pixels.
  *
  * Parameters:
  *   x1 - The X parameter of the first point.
@@ -156,6 +823,7 @@ uint8 lcdst_setWindow(uint8 x1, uint8 y1, uint8 x2, uint8 y2);
 
 /*
  * Set the currently active display to RAM modification mode.
+ * The command is queued and sent together with the following pixels.
  *
  * Parameters: none
  * Return: void
@@ -164,11 +832,13 @@ void lcdst_activateRamWrite(void);
 
 /*
  * Send the raw pixel color to the currently active display.
+ * The pixel is collected in the transmit buffer, see lcdst_sendBuffer().
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
- *   r - The intensity of the red color on a scale from 0 to 255.
- *   g - The intensity of the green color on a scale from 0 to 255.
- *   b - The intensity of the blue color on a scale from 0 to 255.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
  *
  * Return: void
  */
@@ -176,30 +846,126 @@ void lcdst_pushPx(uint8 r, uint8 g, uint8 b);
 
 /*
  * Send two raw pixel colors to the currently active display.
- * This is a function for a pixel with a reduced number of bits.
- *
- * Parameters:
- *   r - The intensity of the red color for the first pixel
- *       on a scale from 0 to 15.
- *   g - The intensity of the green color for the first pixel
- *       on a scale from 0 to 15.
- *   b - The intensity of the blue color for the first pixel
- *       on a scale from 0 to 15.
- *   rr - The intensity of the red color for the second pixel
- *       on a scale from 0 to 15.
- *   gg - The intensity of the green color for the second pixel
- *       on a scale from 0 to 15.
- *   bb - The intensity of the blue color for the second pixel
- *       on a scale from 0 to 15.
+ * It works with every pixel size, like two calls of lcdst_pushPx().
+ * The pixels are collected in the transmit buffer, see lcdst_sendBuffer().
+ * The color intensity scale is from 0 to 255 for every pixel size.
+ *
+ * Parameters:
+ *   r - The intensity of the red color for the first pixel.
+ *   g - The intensity of the green color for the first pixel.
+ *   b - The intensity of the blue color for the first pixel.
+ *   rr - The intensity of the red color for the second pixel.
+ *   gg - The intensity of the green color for the second pixel.
+ *   bb - The intensity of the blue color for the second pixel.
  *
  * Return: void
  */
 void lcdst_pushRPx(uint8 r, uint8 g, uint8 b, uint8 rr, uint8 gg, uint8 bb);
 
+/*
+ * Send the pixels already encoded in the pixel size of the currently active
+ * display, for example prepared once and sent many times. The bytes must
+ * contain whole pixels; In the reduced pixel size whole pairs of pixels,
+ * except the end of the window. The bytes are copied to the transmit buffer,
+ * see lcdst_sendBuffer().
+ *
+ * Parameters:
+ *   data - Pointer to the encoded pixels.
+ *   length - The number of bytes.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ * The framebuffer mode and the unfinished pair of reduced pixels are errors.
+ *
+ */
+uint8 lcdst_pushEncoded(const uint8 *data, unsigned int length);
+
+/*
+ * Send the pixels already encoded in the pixel size of the currently active
+ * display without copying them. It works like lcdst_pushEncoded(), but the
+ * transmit queue refers to the given memory, which must not change until
+ * the buffer is sent, see lcdst_sendBuffer(). It suits the large blocks
+ * of the pixels, for example the mapped image files.
+ *
+ * Parameters:
+ *   data - Pointer to the encoded pixels.
+ *   length - The number of bytes.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ * The framebuffer mode and the unfinished pair of reduced pixels are errors.
+ *
+ */
+uint8 lcdst_queueEncoded(const uint8 *data, unsigned int length);
+
+/*
+ * Draw the bitmap on the currently active display.
+ * The source rows are converted to the pixel size of the display directly
+ * in the transmit buffer (or in the framebuffer), without the temporary copy.
+ * The source color intensities are on a scale from 0 to 255
+ * for every pixel size. The part outside the display space is not drawn.
+ *
+ * Parameters:
+ *   x - Parameter X of the upper left corner of the bitmap.
+ *   y - Parameter Y of the upper left corner of the bitmap.
+ *   w - The width of the bitmap.
+ *   h - The height of the bitmap.
+ *   src - Pointer to the first pixel of the bitmap.
+ *   stride - The distance between the rows in bytes. 0 = packed rows.
+ *   srcFormat - Choose one: ST7735S_SRC_RGB888, ST7735S_SRC_BGR888,
+ *               ST7735S_SRC_RGBA8888 or ST7735S_SRC_RGB565.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_blit(uint8 x, uint8 y, uint8 w, uint8 h,
+				 const void *src, unsigned int stride, uint8 srcFormat);
+
+/*
+ * Draw the whole frame on the currently active display and send only
+ * the changed parts. The frame is split into the tiles, the tiles are hashed
+ * and compared with the hashes of the previous frame. The changed tiles
+ * are merged into a few rectangles, which are drawn like with lcdst_blit().
+ * In the framebuffer mode the rectangles are written to the framebuffer.
+ * The frame has the size of the display in the current orientation.
+ *
+ * The previous frame is assumed to be on the display. After drawing with
+ * other functions, call lcdst_setFrameTiles() to send the next frame whole.
+ * The orientation and the framebuffer mode changes do it automatically.
+ *
+ * Parameters:
+ *   frame - Pointer to the first pixel of the frame.
+ *   stride - The distance between the rows in bytes. 0 = packed rows.
+ *   srcFormat - Choose one: ST7735S_SRC_RGB888, ST7735S_SRC_BGR888,
+ *               ST7735S_SRC_RGBA8888 or ST7735S_SRC_RGB565.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_pushFrame(const void *frame, unsigned int stride, uint8 srcFormat);
+
+/*
+ * Set the size of the tiles compared by lcdst_pushFrame() on the currently
+ * active display and forget the previous frame. The smaller tiles find
+ * the changes more exactly, but cost more hashing and windows.
+ *
+ * Parameters:
+ *   w - The width of the tile; 1 to 160.
+ *   h - The height of the tile; 1 to 160.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setFrameTiles(uint8 w, uint8 h);
+
 /*
  * Draw one pixel on the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * When the pixel continues the previous one in the row, only its color is
+ * sent. The column or the row address is sent only when it changes.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   x - The X parameter of the pixel.
@@ -214,8 +980,7 @@ void lcdst_drawPx(uint8 x, uint8 y, uint8 r, uint8 g, uint8 b);
 
 /*
  * Draw a horizontal line on the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   x - Parameter X of the left end of the line.
@@ -231,8 +996,7 @@ void lcdst_drawHLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b);
 
 /*
  * Draw a vertical line on the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   x - The X parameter of the upper end of the line.
@@ -248,8 +1012,7 @@ void lcdst_drawVLine(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b);
 
 /*
  * Draw a rectangle on the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   x - Parameter X of the upper left corner of the rectangle.
@@ -267,8 +1030,7 @@ void lcdst_drawRect(uint8 x, uint8 y, uint8 w, uint8 h,
 
 /*
  * Draw a filled rectangle on the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   x - Parameter X of the upper left corner of the rectangle.
@@ -286,8 +1048,7 @@ void lcdst_drawFRect(uint8 x, uint8 y, uint8 w, uint8 h,
 
 /*
  * Fill the entire screen with one color of the currently active display.
- * The color intensity scale for a normal pixel is from 0 to 255.
- * The color intensity scale for the reduced pixel is from 0 to 15.
+ * The color intensity scale is from 0 to 255 for every pixel size.
  *
  * Parameters:
  *   r - The intensity of the red color.
@@ -298,6 +1059,359 @@ void lcdst_drawFRect(uint8 x, uint8 y, uint8 w, uint8 h,
  */
 void lcdst_drawScreen(uint8 r, uint8 g, uint8 b);
 
+/*
+ * Draw a line between any two points on the currently active display.
+ * The neighbouring pixels in one row or one column are sent as one span,
+ * with one window per span. The part outside the display space is not drawn.
+ * The color intensity scale is from 0 to 255 for every pixel size.
+ *
+ * Parameters:
+ *   x1 - The X parameter of the first point.
+ *   y1 - The Y parameter of the first point.
+ *   x2 - The X parameter of the second point.
+ *   y2 - The Y parameter of the second point.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_drawLine(int x1, int y1, int x2, int y2,
+					uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw a circle on the currently active display.
+ * The pixels are sent as spans, like in lcdst_drawLine().
+ *
+ * Parameters:
+ *   cx - The X parameter of the center.
+ *   cy - The Y parameter of the center.
+ *   radius - The radius of the circle.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_drawCircle(int cx, int cy, int radius, uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw an arc of a circle on the currently active display.
+ * The arc goes counterclockwise from the first angle to the second one;
+ * The angles apart by whole turns, like 0 and 360, give the whole circle.
+ * The pixels are sent as spans, like in lcdst_drawLine().
+ *
+ * Parameters:
+ *   cx - The X parameter of the center.
+ *   cy - The Y parameter of the center.
+ *   radius - The radius of the circle.
+ *   from - The start angle in degrees; 0 = right, 90 = up.
+ *   to - The end angle in degrees.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_drawArc(int cx, int cy, int radius, int from, int to,
+				   uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw a filled circle on the currently active display.
+ * Each row is sent as one span.
+ *
+ * Parameters:
+ *   cx - The X parameter of the center.
+ *   cy - The Y parameter of the center.
+ *   radius - The radius of the circle.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_fillCircle(int cx, int cy, int radius, uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw a triangle on the currently active display.
+ *
+ * Parameters:
+ *   x1, y1 - The first vertex.
+ *   x2, y2 - The second vertex.
+ *   x3, y3 - The third vertex.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_drawTriangle(int x1, int y1, int x2, int y2, int x3, int y3,
+						uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw a filled triangle on the currently active display.
+ * Each row is sent as one span.
+ *
+ * Parameters:
+ *   x1, y1 - The first vertex.
+ *   x2, y2 - The second vertex.
+ *   x3, y3 - The third vertex.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: void
+ */
+void lcdst_fillTriangle(int x1, int y1, int x2, int y2, int x3, int y3,
+						uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw a filled polygon on the currently active display.
+ * The scanline fill uses the even-odd rule; Each span is sent separately.
+ * The edges are drawn like by lcdst_drawLine(), so the fill covers them.
+ *
+ * Parameters:
+ *   points - The vertices as the pairs: x1, y1, x2, y2, ...
+ *   count - The number of vertices; At least 3.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_fillPolygon(const int *points, unsigned int count,
+						uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw an anti-aliased line on the currently active display.
+ * The color is blended with the framebuffer by the pixel coverage,
+ * so the framebuffer mode is required. Send it with lcdst_flush().
+ *
+ * Parameters:
+ *   x1 - The X parameter of the first point.
+ *   y1 - The Y parameter of the first point.
+ *   x2 - The X parameter of the second point.
+ *   y2 - The Y parameter of the second point.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - There is no framebuffer.
+ *
+ */
+uint8 lcdst_drawLineAA(int x1, int y1, int x2, int y2,
+					   uint8 r, uint8 g, uint8 b);
+
+/*
+ * Draw an anti-aliased circle on the currently active display.
+ * The framebuffer mode is required, like in lcdst_drawLineAA().
+ *
+ * Parameters:
+ *   cx - The X parameter of the center.
+ *   cy - The Y parameter of the center.
+ *   radius - The radius of the circle.
+ *   r - The intensity of the red color.
+ *   g - The intensity of the green color.
+ *   b - The intensity of the blue color.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - There is no framebuffer.
+ *
+ */
+uint8 lcdst_drawCircleAA(int cx, int cy, int radius,
+						 uint8 r, uint8 g, uint8 b);
+
+/*
+ * Load the bitmap font from the BDF file. Every character is placed
+ * in the cell of the font bounding box. Only the characters with the codes
+ * from 0 to 255 are loaded.
+ *
+ * Parameters:
+ *   path - The path to the BDF file.
+ *
+ * Return: Pointer to the font. NULL if an error occurred.
+ *
+ */
+lcdst_font_t *lcdst_loadFont(const char *path);
+
+/*
+ * Release the font loaded by lcdst_loadFont() and drop its glyphs
+ * from the glyph cache.
+ *
+ * Parameters:
+ *   font - Pointer to the font.
+ *
+ * Return: void
+ */
+void lcdst_freeFont(lcdst_font_t *font);
+
+/*
+ * Draw the text on the currently active display. Every glyph is encoded
+ * in the pixel size of the display once for the color pair and kept
+ * in the glyph cache. The text is sent as one window with the rows of the
+ * glyphs copied one after another; In the reduced pixel size with an odd
+ * cell width, every glyph is sent as its own window. The characters, which
+ * the font does not have, are drawn as empty cells. The text ends at the
+ * right edge of the display at the last whole character.
+ * The color intensity scale is from 0 to 255 for every pixel size.
+ *
+ * Parameters:
+ *   x - Parameter X of the upper left corner of the text.
+ *   y - Parameter Y of the upper left corner of the text.
+ *   text - The string to draw.
+ *   font - Pointer to the font, for example &lcdst_font6x8.
+ *   r, g, b - The intensities of the colors of the characters.
+ *   br, bg, bb - The intensities of the colors of the background.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_drawText(uint8 x, uint8 y, const char *text,
+					 const lcdst_font_t *font, uint8 r, uint8 g, uint8 b,
+					 uint8 br, uint8 bg, uint8 bb);
+
+/*
+ * Drop all glyphs from the glyph cache and release its memory.
+ *
+ * Parameters: none
+ * Return: void
+ */
+void lcdst_clearGlyphCache(void);
+
+/*
+ * Set the objects, which the display lists of the currently active display
+ * refer to. The table is not copied, so it must be valid while the lists
+ * are executed.
+ *
+ * Parameters:
+ *   refs - The table of the bitmaps and the fonts; NULL = no objects.
+ *   count - The number of the objects; Up to 255.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setListRefs(const lcdst_listref_t *refs, unsigned int count);
+
+/*
+ * Execute the display list on the currently active display. The list
+ * is the sequence of the operations ST7735S_OP_* with their parameters:
+ *
+ * WINDOW - Set the window and move the write cursor to its start,
+ *          like lcdst_setWindow().
+ * FILL - Write count pixels of one color at the write cursor.
+ * PIXELS - Write count pixels of the source format at the write cursor.
+ * TEXT - Draw n characters like lcdst_drawText() with the font of the ref.
+ * BLIT - Draw the bitmap of the ref like lcdst_blit().
+ *
+ * The pixels of FILL and PIXELS are encoded straight into the transmit
+ * buffer and the runs of FILL with the same color are sent as one. The
+ * window, which the display driver already has, is not set again, and the
+ * whole list is sent at once, so the operations on the same window share
+ * one memory write. TEXT and BLIT change the window. The color intensity
+ * scale is from 0 to 255 for every pixel size.
+ *
+ * Parameters:
+ *   list - The display list.
+ *   length - The length of the list in bytes.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred; The operations
+ * before the wrong one are done.
+ *
+ */
+uint8 lcdst_execute(const uint8 *list, unsigned int length);
+
+/*
+ * The functions on the specified display. They work like the functions
+ * without the 'On' suffix, but on the display given in the first parameter
+ * instead of the currently active one. The different displays can be used
+ * from the different threads at the same time; One display can be used
+ * by one thread at a time. The functions on the currently active display
+ * share the active display, so they should be used from one thread.
+ */
+uint8 lcdst_setChunkSizeOn(lcdst_t *display, unsigned int size);
+uint8 lcdst_sendBufferOn(lcdst_t *display);
+uint8 lcdst_setFramebufferOn(lcdst_t *display, uint8 state);
+uint8 lcdst_flushOn(lcdst_t *display);
+void lcdst_markDirtyOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h);
+uint8 lcdst_setAsyncOn(lcdst_t *display, uint8 state,
+					   lcdst_callback_t callback, void *user);
+uint8 lcdst_submitFrameOn(lcdst_t *display);
+uint8 lcdst_waitFramesOn(lcdst_t *display);
+int lcdst_getFrameEventOn(lcdst_t *display);
+uint8 lcdst_setRenderThreadsOn(lcdst_t *display, unsigned int threads,
+							   uint8 bandHeight);
+uint8 lcdst_renderFrameOn(lcdst_t *display, lcdst_render_t render, void *user);
+uint8 lcdst_getStatsOn(lcdst_t *display, lcdst_stats_t *stats);
+void lcdst_resetStatsOn(lcdst_t *display);
+void lcdst_setTraceOn(lcdst_t *display, lcdst_trace_t trace, void *user);
+uint8 lcdst_getWidthOn(lcdst_t *display);
+uint8 lcdst_getHeightOn(lcdst_t *display);
+void lcdst_setOrientationOn(lcdst_t *display, uint8 orientation);
+uint8 lcdst_setPixelFormatOn(lcdst_t *display, uint8 pixel);
+uint8 lcdst_getPixelFormatOn(lcdst_t *display);
+uint8 lcdst_setDitherOn(lcdst_t *display, uint8 mode);
+uint8 lcdst_setScrollAreaOn(lcdst_t *display, uint8 top, uint8 bottom);
+uint8 lcdst_scrollOn(lcdst_t *display, uint8 lines, uint8 r, uint8 g, uint8 b);
+uint8 lcdst_scrollMapOn(lcdst_t *display, uint8 line);
+void lcdst_setGammaOn(lcdst_t *display, uint8 state);
+void lcdst_setInversionOn(lcdst_t *display, uint8 state);
+uint8 lcdst_setWindowOn(lcdst_t *display,
+						uint8 x1, uint8 y1, uint8 x2, uint8 y2);
+void lcdst_activateRamWriteOn(lcdst_t *display);
+void lcdst_pushPxOn(lcdst_t *display, uint8 r, uint8 g, uint8 b);
+void lcdst_pushRPxOn(lcdst_t *display, uint8 r, uint8 g, uint8 b,
+					 uint8 rr, uint8 gg, uint8 bb);
+uint8 lcdst_pushEncodedOn(lcdst_t *display,
+						  const uint8 *data, unsigned int length);
+uint8 lcdst_queueEncodedOn(lcdst_t *display,
+						   const uint8 *data, unsigned int length);
+uint8 lcdst_blitOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+				   const void *src, unsigned int stride, uint8 srcFormat);
+uint8 lcdst_pushFrameOn(lcdst_t *display, const void *frame,
+						unsigned int stride, uint8 srcFormat);
+uint8 lcdst_setFrameTilesOn(lcdst_t *display, uint8 w, uint8 h);
+void lcdst_drawPxOn(lcdst_t *display, uint8 x, uint8 y,
+					uint8 r, uint8 g, uint8 b);
+void lcdst_drawHLineOn(lcdst_t *display, uint8 x, uint8 y, uint8 l,
+					   uint8 r, uint8 g, uint8 b);
+void lcdst_drawVLineOn(lcdst_t *display, uint8 x, uint8 y, uint8 l,
+					   uint8 r, uint8 g, uint8 b);
+void lcdst_drawRectOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					  uint8 r, uint8 g, uint8 b);
+void lcdst_drawFRectOn(lcdst_t *display, uint8 x, uint8 y, uint8 w, uint8 h,
+					   uint8 r, uint8 g, uint8 b);
+void lcdst_drawScreenOn(lcdst_t *display, uint8 r, uint8 g, uint8 b);
+void lcdst_drawLineOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+					  uint8 r, uint8 g, uint8 b);
+void lcdst_drawCircleOn(lcdst_t *display, int cx, int cy, int radius,
+						uint8 r, uint8 g, uint8 b);
+void lcdst_drawArcOn(lcdst_t *display, int cx, int cy, int radius,
+					 int from, int to, uint8 r, uint8 g, uint8 b);
+void lcdst_fillCircleOn(lcdst_t *display, int cx, int cy, int radius,
+						uint8 r, uint8 g, uint8 b);
+void lcdst_drawTriangleOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						  int x3, int y3, uint8 r, uint8 g, uint8 b);
+void lcdst_fillTriangleOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						  int x3, int y3, uint8 r, uint8 g, uint8 b);
+uint8 lcdst_fillPolygonOn(lcdst_t *display, const int *points,
+						  unsigned int count, uint8 r, uint8 g, uint8 b);
+uint8 lcdst_drawLineAAOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						 uint8 r, uint8 g, uint8 b);
+uint8 lcdst_drawCircleAAOn(lcdst_t *display, int cx, int cy, int radius,
+						   uint8 r, uint8 g, uint8 b);
+uint8 lcdst_drawTextOn(lcdst_t *display, uint8 x, uint8 y, const char *text,
+					   const lcdst_font_t *font, uint8 r, uint8 g, uint8 b,
+					   uint8 br, uint8 bg, uint8 bb);
+uint8 lcdst_setListRefsOn(lcdst_t *display, const lcdst_listref_t *refs,
+						  unsigned int count);
+uint8 lcdst_executeOn(lcdst_t *display, const uint8 *list, unsigned int length);
+
 #ifdef __cplusplus
 }
 #endif
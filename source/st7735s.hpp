@@ -0,0 +1,547 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C++17
+ */
+
+#ifndef _LIBRARY_ST7735S_HPP_
+#define _LIBRARY_ST7735S_HPP_
+#include <cstring>
+#include <utility>
+#include "st7735s.h"
+#include "st7735s_convert.h"
+
+/*
+ * The C++ layer of the library; Only this header. The display is the
+ * template of its transport, pixel size and orientation, so the size of
+ * the display, the encoding of the colors and the calls of the transport
+ * are known at compile time and the loops of the drawing are inlined.
+ * It sends the same commands as the C API (ST7735S_CMD_*) and draws the
+ * same pixels, without the framebuffer and the dithering. The bitmaps
+ * are converted by the kernels of st7735s_convert.c.
+ *
+ * The transport is the class with the functions, which are called directly:
+ *   void transfer(const uint8 *data, unsigned int length);
+ *   void setDC(int level);  (Only when the level changes)
+ *   void delay(unsigned int milliseconds);
+ *
+ * The drawing leaves the bytes in the transmit buffer; flush() sends them,
+ * like lcdst_sendBuffer(). The buffer is sent also when it is full.
+ */
+namespace lcdst
+{
+
+/*
+ * The transport through the backend of the C API, for example of the
+ * simulated display. The display must not be drawn by the C API while
+ * the template uses its backend.
+ */
+class CBackend
+{
+public:
+	CBackend(const lcdst_backend_t *backend, void *context)
+		: backend(backend), context(context), level(0) {}
+
+	/* The backend of the display opened by the C API; It stays the owner */
+	explicit CBackend(const lcdst_t *display)
+		: CBackend(display->backend, display->context) {}
+
+	void transfer(const uint8 *data, unsigned int length)
+	{
+		lcdst_segment_t segment = {data, length, level};
+
+		if(backend->transfer != nullptr)
+			backend->transfer(context, data, length);
+		else backend->transferv(context, &segment, 1);
+	} /* transfer */
+
+	void setDC(int level)
+	{
+		this->level = level;
+		backend->setDC(context, level);
+	} /* setDC */
+
+	void delay(unsigned int milliseconds)
+	{
+		if(backend->delay != nullptr) backend->delay(context, milliseconds);
+	} /* delay */
+
+private:
+	const lcdst_backend_t *backend;
+	void *context;
+	uint8 level;
+};
+
+/*
+ * The display. The start sequence is sent by begin(), not by the
+ * constructor, which only passes its arguments to the transport.
+ *
+ * Parameters of the template:
+ *   Backend - The transport.
+ *   Pixel - The pixel size; ST7735S_PIXEL_*.
+ *   Orientation - 0 to 3, like lcdst_setOrientation().
+ *   Chunk - The size of the transmit buffer; At least 6.
+ */
+template<class Backend, uint8 Pixel = ST7735S_CFG_PIXEL,
+		 uint8 Orientation = 0, unsigned int Chunk = ST7735S_CFG_CHUNK>
+class Display
+{
+	static_assert((Pixel == ST7735S_PIXEL_FULL)
+				  || (Pixel == ST7735S_PIXEL_MEDIUM)
+				  || (Pixel == ST7735S_PIXEL_REDUCED), "Wrong pixel size");
+	static_assert(Orientation < 4, "Wrong orientation");
+	static_assert(Chunk >= 6, "Wrong chunk size");
+
+public:
+	/* The size of the display in the orientation */
+	static constexpr uint8 width  = (Orientation % 2) ? 160 : 128;
+	static constexpr uint8 height = (Orientation % 2) ? 128 : 160;
+
+	/*
+	 * The encoded color; In the reduced pixel size the two pixels,
+	 * which take 3 bytes. The intensities are from 0 to 255.
+	 */
+	struct Color
+	{
+		uint8 bytes[3];
+	};
+
+	static constexpr Color encode(uint8 r, uint8 g, uint8 b)
+	{
+		if constexpr(Pixel == ST7735S_PIXEL_MEDIUM)
+			return {{static_cast<uint8>((r & 0xF8) | (g >> 5)),
+					 static_cast<uint8>(((g << 3) & 0xE0) | (b >> 3)), 0}};
+		else if constexpr(Pixel == ST7735S_PIXEL_REDUCED)
+			return {{static_cast<uint8>((r & 0xF0) | (g >> 4)),
+					 static_cast<uint8>((b & 0xF0) | (r >> 4)),
+					 static_cast<uint8>((g & 0xF0) | (b >> 4))}};
+		else return {{r, g, b}};
+	} /* encode */
+
+	template<class... Args>
+	explicit Display(Args &&... args)
+		: backend(std::forward<Args>(args)...) {}
+
+	~Display() {flush();}
+
+	Display(const Display &) = delete;
+	Display &operator=(const Display &) = delete;
+
+	/* The transport, for example to close it */
+	Backend &transport() {return backend;}
+
+	/*
+	 * Start the display driver like lcdst_initBackend(), or take over
+	 * the running one like lcdst_attachBus(), and set the pixel size,
+	 * the orientation and the whole window.
+	 *
+	 * Parameters:
+	 *   start - 1 = send the start sequence; 0 = keep the image.
+	 */
+	void begin(uint8 start = 1)
+	{
+		if(start)
+		{
+			/* The waits are the minimums of the datasheet */
+			command(ST7735S_CMD_SWRESET); wait(120);
+			command(ST7735S_CMD_SLPOUT); wait(5);
+			command(ST7735S_CMD_GAMSET); data(0x04);
+			command(ST7735S_CMD_DISPON);
+		}
+		else command(ST7735S_CMD_NORON);
+
+		command(ST7735S_CMD_MADCTL); data(madctl);
+		command(ST7735S_CMD_COLMOD); data(colmod);
+		panelValid = 0;
+		setWindow(0, 0, width - 1, height - 1);
+		flush();
+	} /* begin */
+
+	/* Send the transmit buffer */
+	void flush()
+	{
+		endPixels();
+		send();
+	} /* flush */
+
+	/*
+	 * Set the window and start the memory write, like lcdst_setWindow().
+	 * The addresses, which the display driver already has, are not sent.
+	 *
+	 * Return: 0 - OK; 1 - The window is outside the display.
+	 */
+	uint8 setWindow(uint8 x1, uint8 y1, uint8 x2, uint8 y2)
+	{
+		uint8 column, row;
+
+		if((x2 < x1) || (x2 >= width) || (y2 < y1) || (y2 >= height))
+			return 1;
+
+		column = !panelValid || (panel[0] != x1) || (panel[2] != x2);
+		row    = !panelValid || (panel[1] != y1) || (panel[3] != y2);
+		if(!column && !row && streaming && (streamCount == 0)) return 0;
+
+		if(column)
+		{
+			command(ST7735S_CMD_CASET);
+			data(0); data(x1); data(0); data(x2);
+			panel[0] = x1; panel[2] = x2;
+		}
+		if(row)
+		{
+			command(ST7735S_CMD_RASET);
+			data(0); data(y1); data(0); data(y2);
+			panel[1] = y1; panel[3] = y2;
+		}
+
+		panelValid = 1;
+		command(ST7735S_CMD_RAMWR);
+		return 0;
+	} /* setWindow */
+
+	/* Write one pixel at the write cursor, like lcdst_pushPx() */
+	void pushPx(uint8 r, uint8 g, uint8 b)
+	{
+		uint8 *to;
+
+		streamCount++;
+		if constexpr(Pixel == ST7735S_PIXEL_MEDIUM)
+		{
+			to = reserve(2);
+			to[0] = (r & 0xF8) | (g >> 5);
+			to[1] = ((g << 3) & 0xE0) | (b >> 3);
+		}
+		else if constexpr(Pixel == ST7735S_PIXEL_REDUCED)
+		{
+			if(halfPending)
+			{
+				to = reserve(2);
+				to[0] = half | (r >> 4);
+				to[1] = (g & 0xF0) | (b >> 4);
+				halfPending = 0;
+			}
+			else
+			{
+				to = reserve(1);
+				to[0] = (r & 0xF0) | (g >> 4);
+				half = b & 0xF0;
+				halfPending = 1;
+			}
+		}
+		else
+		{
+			to = reserve(3);
+			to[0] = r; to[1] = g; to[2] = b;
+		}
+	} /* pushPx */
+
+	/*
+	 * Draw the pixel, like lcdst_drawPx(). The window ends at the right
+	 * edge, so the next pixel of the row continues the stream.
+	 */
+	void drawPx(uint8 x, uint8 y, uint8 r, uint8 g, uint8 b)
+	{
+		if(!atCursor(x, y) && setWindow(x, y, width - 1, y)) return;
+		pushPx(r, g, b);
+	} /* drawPx */
+
+	/* Fill the rectangle with the color, like lcdst_drawFRect() */
+	void fill(uint8 x, uint8 y, uint8 w, uint8 h, uint8 r, uint8 g, uint8 b)
+	{
+		if((w == 0) || (h == 0)) return;
+		if(x + w > width)  w = width - x;
+		if(y + h > height) h = height - y;
+		if(setWindow(x, y, x + w - 1, y + h - 1)) return;
+		fillPixels((unsigned long) w * h, encode(r, g, b));
+	} /* fill */
+
+	/* Draw the horizontal span, like lcdst_drawHLine() */
+	void span(uint8 x, uint8 y, uint8 l, uint8 r, uint8 g, uint8 b)
+	{
+		fill(x, y, l, 1, r, g, b);
+	} /* span */
+
+	/* Fill the whole display */
+	void fillScreen(uint8 r, uint8 g, uint8 b)
+	{
+		fill(0, 0, width, height, r, g, b);
+	} /* fillScreen */
+
+	/*
+	 * Draw the bitmap, like lcdst_blit(). The format is the parameter
+	 * of the template, so the converter of the rows is chosen at compile
+	 * time.
+	 *
+	 * Parameters of the template:
+	 *   Src - The source format; ST7735S_SRC_*.
+	 *
+	 * Parameters:
+	 *   x, y - The upper left corner.
+	 *   w, h - The size of the bitmap.
+	 *   src - The first pixel.
+	 *   stride - The distance between the rows in bytes; 0 = packed rows.
+	 *
+	 * Return: 0 - OK; 1 - The bitmap starts outside the display.
+	 */
+	template<uint8 Src>
+	uint8 blit(uint8 x, uint8 y, uint8 w, uint8 h, const void *src,
+			   unsigned int stride = 0)
+	{
+		const uint8 *row = static_cast<const uint8 *>(src);
+
+		/* The packed rows have the width of the whole bitmap */
+		if(stride == 0) stride = w * sourceSize<Src>();
+
+		if((w == 0) || (h == 0)) return 0;
+		if((x >= width) || (y >= height)) return 1;
+		if(x + w > width)  w = width - x;
+		if(y + h > height) h = height - y;
+
+		setWindow(x, y, x + w - 1, y + h - 1);
+		for(; h; h--, row += stride) pushRow<Src>(row, w);
+		endPixels();
+		return 0;
+	} /* blit */
+
+private:
+	static constexpr uint8 madctl = (Orientation == 1) ? 0x60  /* MX + MV */
+								  : (Orientation == 2) ? 0xC0  /* MY + MX */
+								  : (Orientation == 3) ? 0xA0  /* MY + MV */
+								  : 0x00;
+	static constexpr uint8 colmod = (Pixel == ST7735S_PIXEL_MEDIUM) ? 0x05
+								  : (Pixel == ST7735S_PIXEL_REDUCED) ? 0x03
+								  : 0x06;
+
+	/* The bytes of the color pattern; Two pixels in the reduced size */
+	static constexpr unsigned int unit =
+		(Pixel == ST7735S_PIXEL_MEDIUM) ? 2 : 3;
+
+	/* The fill chunk holds the whole patterns of every pixel size */
+	static constexpr unsigned int fillSize = Chunk - Chunk % 6;
+
+	template<uint8 Src>
+	static constexpr unsigned int sourceSize()
+	{
+		return (Src == ST7735S_SRC_RGBA8888) ? 4
+			 : (Src == ST7735S_SRC_RGB565) ? 2 : 3;
+	} /* sourceSize */
+
+	/* Read the source pixel like the converters of st7735s_convert.h */
+	template<uint8 Src>
+	static inline void load(const uint8 *src, uint8 &r, uint8 &g, uint8 &b)
+	{
+		unsigned int v;
+
+		if constexpr(Src == ST7735S_SRC_BGR888)
+		{
+			r = src[2]; g = src[1]; b = src[0];
+		}
+		else if constexpr(Src == ST7735S_SRC_RGB565)
+		{
+			v = src[0] | (src[1] << 8);
+			r = ((v >> 8) & 0xF8) | (v >> 13);
+			g = ((v >> 3) & 0xFC) | ((v >> 9) & 0x03);
+			b = ((v << 3) & 0xF8) | ((v >> 2) & 0x07);
+		}
+		else
+		{
+			r = src[0]; g = src[1]; b = src[2];
+		}
+	} /* load */
+
+	/* Send the buffer with the current level of the D/C line */
+	void send()
+	{
+		if(length == 0) return;
+		backend.transfer(buffer, length);
+		length = 0;
+	} /* send */
+
+	/* Change the level of the D/C line after the bytes of the old level */
+	void setLevel(uint8 dc)
+	{
+		if(dc == level) return;
+		send();
+		backend.setDC(dc);
+		level = dc;
+	} /* setLevel */
+
+	/* Reserve the data bytes at the end of the buffer; Up to 3 */
+	uint8 *reserve(unsigned int n)
+	{
+		uint8 *space;
+
+		setLevel(1);
+		if(Chunk - length < n) send();
+		space = buffer + length;
+		length += n;
+		return space;
+	} /* reserve */
+
+	void command(uint8 cmd)
+	{
+		endPixels();
+		setLevel(0);
+		if(length == Chunk) send();
+		buffer[length++] = cmd;
+
+		/* Every command ends the memory write; RAMWR starts it again */
+		streaming = (cmd == ST7735S_CMD_RAMWR);
+		streamCount = 0;
+	} /* command */
+
+	void data(uint8 byte)
+	{
+		*reserve(1) = byte;
+	} /* data */
+
+	void wait(unsigned int milliseconds)
+	{
+		send();
+		backend.delay(milliseconds);
+	} /* wait */
+
+	/* Send the waiting half of the last reduced pixel */
+	void endPixels()
+	{
+		if constexpr(Pixel == ST7735S_PIXEL_REDUCED)
+		{
+			if(!halfPending) return;
+			halfPending = 0;
+			*reserve(1) = half;
+			streaming = 0;
+		}
+	} /* endPixels */
+
+	/* Check if the write cursor is at the pixel, like in st7735s.c */
+	uint8 atCursor(uint8 x, uint8 y) const
+	{
+		unsigned long w = panel[2] - panel[0] + 1, index;
+
+		if(!streaming) return 0;
+		index = streamCount % (w * (panel[3] - panel[1] + 1));
+		return (x == panel[0] + index % w) && (y == panel[1] + index / w);
+	} /* atCursor */
+
+	/*
+	 * Send the pixels of one color. The pattern is replicated in the fill
+	 * chunk once per color and the chunk is sent repeatedly.
+	 */
+	void fillPixels(unsigned long count, Color color)
+	{
+		unsigned long bytes;
+		unsigned int size;
+
+		/* The stream starts with the whole pixel after setWindow() */
+		if constexpr(Pixel == ST7735S_PIXEL_REDUCED)
+			bytes = (count * 3 + 1) / 2;
+		else bytes = count * unit;
+
+		if(!fillValid || std::memcmp(fillColor.bytes, color.bytes, unit))
+		{
+			fillChunk[0] = color.bytes[0];
+			fillChunk[1] = color.bytes[1];
+			fillChunk[2] = color.bytes[2];
+			for(size = unit; size < fillSize; size *= 2)
+				std::memcpy(fillChunk + size, fillChunk,
+							size * 2 <= fillSize ? size : fillSize - size);
+			fillColor = color;
+			fillValid = 1;
+		}
+
+		/* The chunk is sent without the copy */
+		setLevel(1);
+		send();
+		streamCount += count;
+
+		/* The odd reduced pixels end in the half byte; The stream is broken */
+		if constexpr(Pixel == ST7735S_PIXEL_REDUCED)
+			if(count & 1) streaming = 0;
+		for(; bytes > fillSize; bytes -= fillSize)
+			backend.transfer(fillChunk, fillSize);
+		backend.transfer(fillChunk, bytes);
+	} /* fillPixels */
+
+	/*
+	 * Convert the whole units of the source pixels; One pixel, or two
+	 * in the reduced size. The copy of the 18-bit order is inlined;
+	 * The other formats use the SIMD kernels of st7735s_convert.h.
+	 */
+	template<uint8 Src>
+	static inline void convert(uint8 *to, const uint8 *src, unsigned int units)
+	{
+		if constexpr((Src == ST7735S_SRC_RGB888)
+					 && (Pixel == ST7735S_PIXEL_FULL))
+			std::memcpy(to, src, units * 3);
+		else
+			lcdst_getConverter(Src, Pixel)(to, src,
+				units << (Pixel == ST7735S_PIXEL_REDUCED));
+	} /* convert */
+
+	/* Convert the row of the source pixels into the buffer */
+	template<uint8 Src>
+	void pushRow(const uint8 *src, unsigned int count)
+	{
+		constexpr unsigned int size = sourceSize<Src>();
+		constexpr unsigned int pairs = (Pixel == ST7735S_PIXEL_REDUCED);
+		unsigned int n;
+		uint8 r, g, b, *to;
+
+		/* Complete the pair started in the previous row */
+		if(halfPending && count)
+		{
+			load<Src>(src, r, g, b);
+			pushPx(r, g, b);
+			src += size;
+			count--;
+		}
+
+		while(count > pairs)
+		{
+			/* The pixels, which fit in the buffer */
+			setLevel(1);
+			if(Chunk - length < unit) send();
+			n = ((Chunk - length) / unit) << pairs;
+			if(n > count) n = count >> pairs << pairs;
+			to = buffer + length;
+			length += (n >> pairs) * unit;
+			streamCount += n;
+			count -= n;
+			convert<Src>(to, src, n >> pairs);
+			src += n * size;
+		}
+
+		/* The last single pixel of the reduced size */
+		if(count)
+		{
+			load<Src>(src, r, g, b);
+			pushPx(r, g, b);
+		}
+	} /* pushRow */
+
+	Backend backend;
+
+	/* The transmit buffer; The level of its bytes; 2 = unknown */
+	uint8 buffer[Chunk];
+	unsigned int length = 0;
+	uint8 level = 2;
+
+	/* The shadow of the window in the display driver; The memory write */
+	uint8 panel[4] = {0, 0, 0, 0};
+	uint8 panelValid = 0, streaming = 0;
+	unsigned long streamCount = 0;
+
+	/* The half of the byte waiting in the reduced size */
+	uint8 half = 0, halfPending = 0;
+
+	/* The chunk with the replicated pattern of the last fill color */
+	alignas(64) uint8 fillChunk[fillSize];
+	Color fillColor = {{0, 0, 0}};
+	uint8 fillValid = 0;
+};
+
+} /* namespace lcdst */
+
+#endif /* _LIBRARY_ST7735S_HPP_ */
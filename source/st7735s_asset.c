@@ -0,0 +1,385 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "st7735s.h"
+#include "st7735s_asset.h"
+
+/* The longest row drawn at once; Wider than every orientation */
+#define ROW_PIXELS 256
+
+/*
+ * Allocate the memory block. If an error occurs, stop the program.
+ *
+ * Parameters:
+ *   size - Size of memory block to allocate.
+ *
+ * Return:
+ *   Pointer to the memory block. If an error occurs, stop the program.
+ */
+static void *safeMalloc(size_t size)
+{
+	void *memoryBlock = malloc(size);
+	
+	/* Check the pointer */
+	if(memoryBlock == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return memoryBlock;
+} /* safeMalloc */
+
+/* Read the little-endian numbers of the header */
+static inline unsigned int read16(const uint8 *p)
+{
+	return p[0] | (p[1] << 8);
+} /* read16 */
+
+static inline unsigned long read32(const uint8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long) p[3] << 24);
+} /* read32 */
+
+size_t lcdst_getEncodedSize(uint8 pixel, size_t count)
+{
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  return count * 2;
+		case ST7735S_PIXEL_REDUCED: return (count * 3 + 1) / 2;
+		default:                    return count * 3;
+	}
+} /* lcdst_getEncodedSize */
+
+/*
+ * Get the size of the tile; The tiles at the right and at the bottom edge
+ * of the image may be smaller.
+ */
+static inline unsigned int tileWidth(const lcdst_asset_t *asset,
+									 unsigned int column)
+{
+	unsigned int rest = asset->width - column * asset->tileWidth;
+	
+	return (rest < asset->tileWidth) ? rest : asset->tileWidth;
+} /* tileWidth */
+
+static inline unsigned int tileHeight(const lcdst_asset_t *asset,
+									  unsigned int row)
+{
+	unsigned int rest = asset->height - row * asset->tileHeight;
+	
+	return (rest < asset->tileHeight) ? rest : asset->tileHeight;
+} /* tileHeight */
+
+/*
+ * Get the encoded pixels of the tile in the mapped file.
+ */
+static inline const uint8 *tileData(const lcdst_asset_t *asset,
+									unsigned int column, unsigned int row)
+{
+	unsigned int tile = row * asset->columns + column;
+	
+	return asset->map + read32(asset->map + ST7735S_ASSET_HEADER + 4 * tile);
+} /* tileData */
+
+/*
+ * Check the header and the tile index of the mapped file
+ * and fill the fields of the asset.
+ *
+ * Return: 0 - The asset is valid; 1 - The asset is broken.
+ */
+static uint8 parseAsset(lcdst_asset_t *asset)
+{
+	const uint8 *map = asset->map;
+	unsigned int column, row;
+	unsigned long offset;
+	size_t size;
+	
+	if(asset->size < ST7735S_ASSET_HEADER) return 1;
+	if(memcmp(map, ST7735S_ASSET_MAGIC, 4)) return 1;
+	if(map[4] != ST7735S_ASSET_VERSION) return 1;
+	
+	asset->pixel = map[5];
+	if((asset->pixel != ST7735S_PIXEL_FULL)
+	&& (asset->pixel != ST7735S_PIXEL_MEDIUM)
+	&& (asset->pixel != ST7735S_PIXEL_REDUCED)) return 1;
+	
+	asset->width  = read16(map + 6);
+	asset->height = read16(map + 8);
+	if((asset->width == 0) || (asset->height == 0)) return 1;
+	
+	/* Without the tiles the whole image is one tile */
+	asset->tileWidth  = read16(map + 10);
+	asset->tileHeight = read16(map + 12);
+	if(asset->tileWidth == 0)  asset->tileWidth  = asset->width;
+	if(asset->tileHeight == 0) asset->tileHeight = asset->height;
+	asset->columns = (asset->width + asset->tileWidth - 1) / asset->tileWidth;
+	asset->rows = (asset->height + asset->tileHeight - 1) / asset->tileHeight;
+	
+	if(read32(map + 16) != (unsigned long) asset->columns * asset->rows)
+		return 1;
+	if(asset->size < ST7735S_ASSET_HEADER
+				   + 4 * (size_t) asset->columns * asset->rows) return 1;
+	
+	/* Every tile must lie inside the file */
+	for(row = 0; row < asset->rows; row++)
+	{
+		for(column = 0; column < asset->columns; column++)
+		{
+			offset = tileData(asset, column, row) - map;
+			size = lcdst_getEncodedSize(asset->pixel,
+				(size_t) tileWidth(asset, column) * tileHeight(asset, row));
+			if((offset > asset->size) || (asset->size - offset < size))
+				return 1;
+		}
+	}
+	
+	return 0;
+} /* parseAsset */
+
+lcdst_asset_t *lcdst_openAsset(const char *path)
+{
+	lcdst_asset_t *asset;
+	struct stat info;
+	void *map;
+	int fd;
+	
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if(fd == -1) return NULL;
+	
+	if((fstat(fd, &info) == -1) || (info.st_size == 0))
+	{
+		close(fd);
+		return NULL;
+	}
+	
+	/* The mapping stays valid after the file is closed */
+	map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) return NULL;
+	
+	asset = (lcdst_asset_t *) safeMalloc(sizeof(lcdst_asset_t));
+	asset->map = (const uint8 *) map;
+	asset->size = info.st_size;
+	
+	if(parseAsset(asset))
+	{
+		lcdst_closeAsset(asset);
+		return NULL;
+	}
+	
+	return asset;
+} /* lcdst_openAsset */
+
+void lcdst_closeAsset(lcdst_asset_t *asset)
+{
+	if(asset == NULL) return;
+	
+	munmap((void *) asset->map, asset->size);
+	free(asset);
+} /* lcdst_closeAsset */
+
+/*
+ * Decode the encoded pixels to the RGB888 format.
+ * The components are expanded to the scale from 0 to 255.
+ *
+ * Parameters:
+ *   dst - The destination; 3 bytes per pixel.
+ *   data - The encoded pixels of the tile.
+ *   index - The number of the first pixel in the tile.
+ *   count - The number of pixels.
+ */
+static void decodePixels(uint8 *dst, const uint8 *data, uint8 pixel,
+						 size_t index, unsigned int count)
+{
+	const uint8 *p;
+	unsigned int v;
+	
+	for(; count; count--, index++, dst += 3)
+	{
+		switch(pixel)
+		{
+			case ST7735S_PIXEL_MEDIUM:
+				p = data + index * 2;
+				v = (p[0] << 8) | p[1];
+				dst[0] = ((v >> 8) & 0xF8) | (v >> 13);
+				dst[1] = ((v >> 3) & 0xFC) | ((v >> 9) & 0x03);
+				dst[2] = ((v << 3) & 0xF8) | ((v >> 2) & 0x07);
+				break;
+	
+			case ST7735S_PIXEL_REDUCED:
+				/* Two pixels share three bytes */
+				p = data + index / 2 * 3;
+				if(index & 1)
+				{
+					dst[0] = (p[1] & 0x0F) * 0x11;
+					dst[1] = (p[2] >> 4) * 0x11;
+					dst[2] = (p[2] & 0x0F) * 0x11;
+				}
+				else
+				{
+					dst[0] = (p[0] >> 4) * 0x11;
+					dst[1] = (p[0] & 0x0F) * 0x11;
+					dst[2] = (p[1] >> 4) * 0x11;
+				}
+				break;
+	
+			default:
+				memcpy(dst, data + index * 3, 3);
+				break;
+		}
+	}
+} /* decodePixels */
+
+/*
+ * Draw the part of one tile; The part is inside the display space.
+ * The pixels are queued straight from the mapping, when the pixel sizes
+ * match and the reduced pixels start on the whole byte in every row.
+ * Otherwise every row is decoded and drawn like a bitmap.
+ *
+ * Parameters:
+ *   column, row - The tile.
+ *   tx, ty - The upper left corner of the part in the tile.
+ *   w, h - The size of the part.
+ *   x, y - The upper left corner of the part on the display.
+ */
+static uint8 drawPart(lcdst_t *display, const lcdst_asset_t *asset,
+					  unsigned int column, unsigned int row,
+					  unsigned int tx, unsigned int ty, unsigned int w,
+					  unsigned int h, uint8 x, uint8 y)
+{
+	const uint8 *data = tileData(asset, column, row);
+	unsigned int width = tileWidth(asset, column), i;
+	uint8 pixel = asset->pixel, rgb[ROW_PIXELS * 3];
+	size_t start = (size_t) ty * width + tx;
+	int direct;
+	
+	direct = (display->framebuffer == NULL) && (display->pixel == pixel);
+	if(direct && (pixel == ST7735S_PIXEL_REDUCED))
+	{
+		/* The full width part is one block, otherwise every row starts */
+		if(w == width) direct = !(start & 1);
+		else direct = !((tx | width | w) & 1);
+	}
+	
+	if(direct)
+	{
+		if(lcdst_setWindowOn(display, x, y, x+w-1, y+h-1)) return 1;
+	
+		/* The rows of the part follow each other in the tile */
+		if(w == width)
+			return lcdst_queueEncodedOn(display,
+				data + lcdst_getEncodedSize(pixel, start),
+				lcdst_getEncodedSize(pixel, (size_t) w * h));
+	
+		for(i = 0; i < h; i++, start += width)
+			if(lcdst_queueEncodedOn(display,
+				   data + lcdst_getEncodedSize(pixel, start),
+				   lcdst_getEncodedSize(pixel, w))) return 1;
+		return 0;
+	}
+	
+	for(i = 0; i < h; i++, start += width)
+	{
+		decodePixels(rgb, data, pixel, start, w);
+		if(lcdst_blitOn(display, x, y + i, w, 1, rgb, 0, ST7735S_SRC_RGB888))
+			return 1;
+	}
+	
+	return 0;
+} /* drawPart */
+
+/*
+ * Draw the region of the asset; The sizes are not limited to the display.
+ */
+static uint8 drawRegion(lcdst_t *display, uint8 x, uint8 y,
+						const lcdst_asset_t *asset, unsigned int sx,
+						unsigned int sy, unsigned int w, unsigned int h)
+{
+	unsigned int column, row, x1, y1, x2, y2, tx, ty;
+	uint8 result = 0;
+	
+	if(asset == NULL) return 1;
+	
+	/* Draw only in the display space and inside the asset */
+	if((sx >= asset->width) || (sy >= asset->height)) return 1;
+	if((x >= display->width) || (y >= display->height)) return 1;
+	if((w == 0) || (w > asset->width - sx))  w = asset->width - sx;
+	if((h == 0) || (h > asset->height - sy)) h = asset->height - sy;
+	if(w > (unsigned int) display->width - x)  w = display->width - x;
+	if(h > (unsigned int) display->height - y) h = display->height - y;
+	
+	/* The parts of the tiles crossed by the region */
+	for(row = sy / asset->tileHeight; !result; row++)
+	{
+		ty = row * asset->tileHeight;
+		if(ty >= sy + h) break;
+		y1 = (sy > ty) ? sy : ty;
+		y2 = (sy + h < ty + asset->tileHeight) ? sy + h
+											   : ty + asset->tileHeight;
+	
+		for(column = sx / asset->tileWidth; !result; column++)
+		{
+			tx = column * asset->tileWidth;
+			if(tx >= sx + w) break;
+			x1 = (sx > tx) ? sx : tx;
+			x2 = (sx + w < tx + asset->tileWidth) ? sx + w
+												  : tx + asset->tileWidth;
+	
+			result = drawPart(display, asset, column, row, x1 - tx, y1 - ty,
+							  x2 - x1, y2 - y1, x + (x1 - sx), y + (y1 - sy));
+		}
+	}
+	
+	/* The queue refers to the mapping; Send it before the asset is closed */
+	if(display->framebuffer == NULL) result |= lcdst_sendBufferOn(display);
+	
+	return result;
+} /* drawRegion */
+
+uint8 lcdst_drawAssetOn(lcdst_t *display, uint8 x, uint8 y,
+						const lcdst_asset_t *asset, unsigned int sx,
+						unsigned int sy, uint8 w, uint8 h)
+{
+	return drawRegion(display, x, y, asset, sx, sy, w, h);
+} /* lcdst_drawAssetOn */
+
+uint8 lcdst_drawAssetTileOn(lcdst_t *display, uint8 x, uint8 y,
+							const lcdst_asset_t *asset, unsigned int tile)
+{
+	unsigned int column, row;
+	
+	if(asset == NULL) return 1;
+	if(tile >= asset->columns * asset->rows) return 1;
+	
+	column = tile % asset->columns;
+	row = tile / asset->columns;
+	return drawRegion(display, x, y, asset,
+					  column * asset->tileWidth, row * asset->tileHeight,
+					  tileWidth(asset, column), tileHeight(asset, row));
+} /* lcdst_drawAssetTileOn */
+
+uint8 lcdst_drawAsset(uint8 x, uint8 y, const lcdst_asset_t *asset,
+					  unsigned int sx, unsigned int sy, uint8 w, uint8 h)
+{
+	return lcdst_drawAssetOn(lcdst_getActiveDisplay(), x, y, asset,
+							 sx, sy, w, h);
+} /* lcdst_drawAsset */
+
+uint8 lcdst_drawAssetTile(uint8 x, uint8 y, const lcdst_asset_t *asset,
+						  unsigned int tile)
+{
+	return lcdst_drawAssetTileOn(lcdst_getActiveDisplay(), x, y, asset, tile);
+} /* lcdst_drawAssetTile */
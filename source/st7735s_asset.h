@@ -0,0 +1,141 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#ifndef _LIBRARY_ST7735S_ASSET_
+#define _LIBRARY_ST7735S_ASSET_
+#include <stddef.h>
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The asset file holds one image already encoded in the pixel size
+ * of the display. All numbers are little-endian.
+ *
+ *   Offset  Size  Field
+ *    0       4    Magic "LCDA"
+ *    4       1    Version; ST7735S_ASSET_VERSION
+ *    5       1    Pixel size; ST7735S_PIXEL_FULL, _MEDIUM or _REDUCED
+ *    6       2    Width of the image
+ *    8       2    Height of the image
+ *   10       2    Width of the tile; 0 = the whole image is one tile
+ *   12       2    Height of the tile; 0 = the whole image is one tile
+ *   14       2    Reserved; 0
+ *   16       4    Number of the tiles
+ *   20     4 * n  Offsets of the tiles from the beginning of the file
+ *
+ * The tiles cover the image in the order of the rows; The tiles at the right
+ * and at the bottom edge may be smaller. The rows of the tile follow each
+ * other without padding, so every tile is one block of the pixel stream
+ * and a whole tile is sent as it is stored. In the reduced pixel size two
+ * pixels share three bytes and the odd last pixel of the tile takes two.
+ */
+#define ST7735S_ASSET_MAGIC "LCDA"
+#define ST7735S_ASSET_VERSION 1
+#define ST7735S_ASSET_HEADER 20
+
+/* The asset file mapped into the memory */
+typedef struct
+{
+	const uint8 *map;              /* The whole file */
+	size_t size;                   /* The size of the file */
+	unsigned int width, height;    /* The size of the image */
+	unsigned int tileWidth;        /* The size of the tile */
+	unsigned int tileHeight;
+	unsigned int columns, rows;    /* The grid of the tiles */
+	uint8 pixel;                   /* The pixel size of the data */
+} lcdst_asset_t;
+
+/*
+ * Get the number of bytes of the encoded pixels.
+ *
+ * Parameters:
+ *   pixel - The pixel size; ST7735S_PIXEL_*.
+ *   count - The number of pixels.
+ *
+ * Return: The number of bytes.
+ */
+size_t lcdst_getEncodedSize(uint8 pixel, size_t count);
+
+/*
+ * Map the asset file into the memory. The header and the tile index are
+ * checked, so the drawing does not read outside the file.
+ *
+ * Parameters:
+ *   path - Path to the asset file.
+ *
+ * Return: Pointer to the asset; NULL if the file can not be mapped
+ *         or it is not a valid asset.
+ */
+lcdst_asset_t *lcdst_openAsset(const char *path);
+
+/*
+ * Unmap the asset file. The data queued from the asset is sent
+ * by the drawing functions, so the asset can be closed right after them.
+ *
+ * Parameters:
+ *   asset - Pointer to the asset.
+ *
+ * Return: void
+ */
+void lcdst_closeAsset(lcdst_asset_t *asset);
+
+/*
+ * Draw the region of the asset on the currently active display.
+ * If the asset has the pixel size of the display and the framebuffer mode
+ * is off, the pixels are sent straight from the mapped file without
+ * the copy: The whole tiles and the full width parts of the tiles as one
+ * block, the other parts row by row. The reduced pixels, which do not start
+ * on the whole byte, and the other pixel sizes are decoded and drawn
+ * like with lcdst_blit(). The part outside the display space is not drawn.
+ *
+ * Parameters:
+ *   x - Parameter X of the upper left corner on the display.
+ *   y - Parameter Y of the upper left corner on the display.
+ *   asset - Pointer to the asset.
+ *   sx - Parameter X of the upper left corner of the region in the asset.
+ *   sy - Parameter Y of the upper left corner of the region in the asset.
+ *   w - The width of the region; 0 = to the right edge of the asset.
+ *   h - The height of the region; 0 = to the bottom edge of the asset.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_drawAsset(uint8 x, uint8 y, const lcdst_asset_t *asset,
+					  unsigned int sx, unsigned int sy, uint8 w, uint8 h);
+
+/*
+ * Draw one tile of the asset on the currently active display,
+ * like lcdst_drawAsset() with the region of the tile.
+ *
+ * Parameters:
+ *   x - Parameter X of the upper left corner on the display.
+ *   y - Parameter Y of the upper left corner on the display.
+ *   asset - Pointer to the asset.
+ *   tile - The number of the tile; In the order of the rows.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_drawAssetTile(uint8 x, uint8 y, const lcdst_asset_t *asset,
+						  unsigned int tile);
+
+/* The functions on the specified display, like in st7735s.h */
+uint8 lcdst_drawAssetOn(lcdst_t *display, uint8 x, uint8 y,
+						const lcdst_asset_t *asset, unsigned int sx,
+						unsigned int sy, uint8 w, uint8 h);
+uint8 lcdst_drawAssetTileOn(lcdst_t *display, uint8 x, uint8 y,
+							const lcdst_asset_t *asset, unsigned int tile);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_ASSET_ */
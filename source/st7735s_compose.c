@@ -0,0 +1,393 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "st7735s.h"
+#include "st7735s_compose.h"
+#include "st7735s_convert.h"
+
+/* The cost of the window setup in pixels, like in st7735s.c */
+#define WINDOW_COST 32
+
+/*
+ * Allocate the memory block. If an error occurs, stop the program.
+ *
+ * Parameters:
+ *   size - Size of memory block to allocate.
+ *
+ * Return:
+ *   Pointer to the memory block. If an error occurs, stop the program.
+ */
+static void *safeMalloc(size_t size)
+{
+	void *memoryBlock = malloc(size);
+	
+	/* Check the pointer */
+	if(memoryBlock == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return memoryBlock;
+} /* safeMalloc */
+
+/*
+ * Compute the number of pixels in the rectangle.
+ */
+static inline int rectArea(const lcdst_rect_t *rect)
+{
+	return (rect->x2 - rect->x1 + 1) * (rect->y2 - rect->y1 + 1);
+} /* rectArea */
+
+/*
+ * Compute the bounding rectangle of the two rectangles.
+ */
+static inline lcdst_rect_t rectUnion(const lcdst_rect_t *a,
+									 const lcdst_rect_t *b)
+{
+	lcdst_rect_t result;
+	
+	result.x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+	result.y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+	result.x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+	result.y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+	
+	return result;
+} /* rectUnion */
+
+/*
+ * Compute the number of pixels composed needlessly, if the two rectangles
+ * are composed as their bounding rectangle.
+ */
+static inline int mergeWaste(const lcdst_rect_t *a, const lcdst_rect_t *b)
+{
+	lcdst_rect_t bound = rectUnion(a, b);
+	return rectArea(&bound) - rectArea(a) - rectArea(b);
+} /* mergeWaste */
+
+/*
+ * Mark the region to compose. The part outside the space is cut off.
+ * The regions are merged like the dirty rectangles of the framebuffer:
+ * When it costs less than the second window, or the list is full.
+ */
+static void markRegion(lcdst_compositor_t *compositor, int x, int y,
+					   int w, int h)
+{
+	lcdst_rect_t *dirty = compositor->dirty, rect;
+	unsigned int i, j, bestI = 0, bestJ = 1;
+	int waste, bestWaste;
+	
+	/* Cut the region to the space */
+	if(x < 0) {w += x; x = 0;}
+	if(y < 0) {h += y; y = 0;}
+	if(x + w > compositor->width)  w = compositor->width - x;
+	if(y + h > compositor->height) h = compositor->height - y;
+	if((w <= 0) || (h <= 0)) return;
+	
+	rect.x1 = x; rect.y1 = y; rect.x2 = x + w - 1; rect.y2 = y + h - 1;
+	for(;;)
+	{
+		/* Find the region which is cheap to merge */
+		for(i = 0; i < compositor->dirtyCount; i++)
+			if(mergeWaste(&rect, &dirty[i]) <= WINDOW_COST) break;
+		if(i == compositor->dirtyCount) break;
+	
+		/* Take it out of the list and try again with the bigger one */
+		rect = rectUnion(&rect, &dirty[i]);
+		dirty[i] = dirty[--compositor->dirtyCount];
+	}
+	
+	/* The list has one spare place for the new region */
+	dirty[compositor->dirtyCount++] = rect;
+	if(compositor->dirtyCount <= ST7735S_CFG_DIRTY) return;
+	
+	/* Merge the cheapest pair to make the place */
+	bestWaste = mergeWaste(&dirty[0], &dirty[1]);
+	for(i = 0; i < compositor->dirtyCount; i++)
+		for(j = i + 1; j < compositor->dirtyCount; j++)
+		{
+			waste = mergeWaste(&dirty[i], &dirty[j]);
+			if(waste < bestWaste) {bestWaste = waste; bestI = i; bestJ = j;}
+		}
+	
+	dirty[bestI] = rectUnion(&dirty[bestI], &dirty[bestJ]);
+	dirty[bestJ] = dirty[--compositor->dirtyCount];
+} /* markRegion */
+
+/*
+ * Mark the place of the sprite, if it is shown.
+ */
+static inline void markSprite(lcdst_compositor_t *compositor,
+							  const lcdst_sprite_t *sprite)
+{
+	if(sprite->visible && sprite->alpha)
+		markRegion(compositor, sprite->x, sprite->y,
+				   sprite->width, sprite->height);
+} /* markSprite */
+
+lcdst_compositor_t *lcdst_createCompositor(uint8 width, uint8 height)
+{
+	lcdst_compositor_t *compositor;
+	size_t size = (size_t) width * height * 4;
+	unsigned int i;
+	
+	if((width == 0) || (height == 0)) return NULL;
+	
+	compositor = (lcdst_compositor_t *) safeMalloc(sizeof(lcdst_compositor_t));
+	compositor->width = width;
+	compositor->height = height;
+	compositor->background = (uint8 *) safeMalloc(size);
+	compositor->scratch = (uint8 *) safeMalloc(size);
+	compositor->serial = 0;
+	compositor->dirtyCount = 0;
+	for(i = 0; i < ST7735S_CFG_SPRITES; i++)
+		compositor->sprites[i].pixels = NULL;
+	
+	/* The black opaque background; The display content is unknown */
+	for(i = 0; i < size; i += 4)
+	{
+		compositor->background[i] = compositor->background[i+1] = 0;
+		compositor->background[i+2] = 0;
+		compositor->background[i+3] = 255;
+	}
+	markRegion(compositor, 0, 0, width, height);
+	
+	return compositor;
+} /* lcdst_createCompositor */
+
+void lcdst_destroyCompositor(lcdst_compositor_t *compositor)
+{
+	if(compositor == NULL) return;
+	
+	free(compositor->scratch);
+	free(compositor->background);
+	free(compositor);
+} /* lcdst_destroyCompositor */
+
+uint8 lcdst_setBackground(lcdst_compositor_t *compositor, uint8 x, uint8 y,
+						  uint8 w, uint8 h, const void *src,
+						  unsigned int stride, uint8 srcFormat)
+{
+	lcdst_convert_t convert = lcdst_getConverter(srcFormat,
+												 ST7735S_PIXEL_FULL);
+	unsigned int srcSize = lcdst_getSourceSize(srcFormat), i;
+	const uint8 *row = (const uint8 *) src;
+	uint8 *to, *rgb = compositor->scratch;
+	
+	if((convert == NULL) || (src == NULL)) return 1;
+	
+	/* The packed rows have the width of the whole bitmap */
+	if(stride == 0) stride = w * srcSize;
+	
+	/* Copy only in the space */
+	if((w == 0) || (h == 0)) return 0;
+	if((x >= compositor->width) || (y >= compositor->height)) return 1;
+	if((x+w-1) >= compositor->width)  w = compositor->width  - x;
+	if((y+h-1) >= compositor->height) h = compositor->height - y;
+	markRegion(compositor, x, y, w, h);
+	
+	/* Convert the rows to RGB888 and widen them to the layer */
+	to = compositor->background + ((size_t) y * compositor->width + x) * 4;
+	for(; h; h--, row += stride, to += compositor->width * 4)
+	{
+		convert(rgb, row, w);
+		for(i = 0; i < w; i++)
+		{
+			to[i*4] = rgb[i*3];
+			to[i*4+1] = rgb[i*3+1];
+			to[i*4+2] = rgb[i*3+2];
+		}
+	}
+	
+	return 0;
+} /* lcdst_setBackground */
+
+lcdst_sprite_t *lcdst_addSprite(lcdst_compositor_t *compositor,
+								const uint8 *pixels, uint8 w, uint8 h, int z)
+{
+	lcdst_sprite_t *sprite;
+	unsigned int i;
+	
+	if((pixels == NULL) || (w == 0) || (h == 0)) return NULL;
+	
+	for(i = 0; i < ST7735S_CFG_SPRITES; i++)
+		if(compositor->sprites[i].pixels == NULL) break;
+	if(i == ST7735S_CFG_SPRITES) return NULL;
+	
+	sprite = &compositor->sprites[i];
+	sprite->pixels = pixels;
+	sprite->x = sprite->y = 0;
+	sprite->width = w;
+	sprite->height = h;
+	sprite->alpha = 255;
+	sprite->visible = 0;
+	sprite->z = z;
+	sprite->serial = compositor->serial++;
+	
+	return sprite;
+} /* lcdst_addSprite */
+
+void lcdst_removeSprite(lcdst_compositor_t *compositor,
+						lcdst_sprite_t *sprite)
+{
+	markSprite(compositor, sprite);
+	sprite->pixels = NULL;
+} /* lcdst_removeSprite */
+
+void lcdst_moveSprite(lcdst_compositor_t *compositor, lcdst_sprite_t *sprite,
+					  int x, int y)
+{
+	if((sprite->x == x) && (sprite->y == y)) return;
+	
+	markSprite(compositor, sprite);
+	sprite->x = x;
+	sprite->y = y;
+	markSprite(compositor, sprite);
+} /* lcdst_moveSprite */
+
+void lcdst_showSprite(lcdst_compositor_t *compositor, lcdst_sprite_t *sprite,
+					  uint8 state)
+{
+	state = state ? 1 : 0;
+	if(sprite->visible == state) return;
+	
+	markSprite(compositor, sprite);
+	sprite->visible = state;
+	markSprite(compositor, sprite);
+} /* lcdst_showSprite */
+
+void lcdst_setSpriteAlpha(lcdst_compositor_t *compositor,
+						  lcdst_sprite_t *sprite, uint8 alpha)
+{
+	if(sprite->alpha == alpha) return;
+	
+	markSprite(compositor, sprite);
+	sprite->alpha = alpha;
+	markSprite(compositor, sprite);
+} /* lcdst_setSpriteAlpha */
+
+void lcdst_setSpriteOrder(lcdst_compositor_t *compositor,
+						  lcdst_sprite_t *sprite, int z)
+{
+	if(sprite->z == z) return;
+	
+	sprite->z = z;
+	markSprite(compositor, sprite);
+} /* lcdst_setSpriteOrder */
+
+void lcdst_setSpritePixels(lcdst_compositor_t *compositor,
+						   lcdst_sprite_t *sprite, const uint8 *pixels)
+{
+	if(pixels == NULL) return;
+	
+	sprite->pixels = pixels;
+	markSprite(compositor, sprite);
+} /* lcdst_setSpritePixels */
+
+/*
+ * Sort the shown sprites from the bottom to the top.
+ *
+ * Return: The number of the sorted sprites.
+ */
+static unsigned int sortSprites(lcdst_compositor_t *compositor,
+								lcdst_sprite_t **order)
+{
+	lcdst_sprite_t *sprite;
+	unsigned int count = 0, i, j;
+	
+	for(i = 0; i < ST7735S_CFG_SPRITES; i++)
+	{
+		sprite = &compositor->sprites[i];
+		if((sprite->pixels == NULL) || !sprite->visible || !sprite->alpha)
+			continue;
+	
+		/* The insertion; The few sprites are almost sorted */
+		for(j = count; j > 0; j--)
+		{
+			if((order[j-1]->z < sprite->z) || ((order[j-1]->z == sprite->z)
+			&& (order[j-1]->serial < sprite->serial))) break;
+			order[j] = order[j-1];
+		}
+		order[j] = sprite;
+		count++;
+	}
+	
+	return count;
+} /* sortSprites */
+
+/*
+ * Compose the region to the scratch buffer; Its rows are packed.
+ * The background is copied and the sprites are blended over it.
+ */
+static void composeRegion(lcdst_compositor_t *compositor,
+						  const lcdst_rect_t *rect,
+						  lcdst_sprite_t *const *order, unsigned int count)
+{
+	unsigned int w = rect->x2 - rect->x1 + 1, i;
+	const lcdst_sprite_t *sprite;
+	int left, top, right, bottom, y;
+	uint8 *to = compositor->scratch;
+	
+	for(y = rect->y1; y <= rect->y2; y++, to += w * 4)
+		memcpy(to, compositor->background
+			   + ((size_t) y * compositor->width + rect->x1) * 4, w * 4);
+	
+	for(i = 0; i < count; i++)
+	{
+		/* The part of the sprite in the region */
+		sprite = order[i];
+		left   = sprite->x > rect->x1 ? sprite->x : rect->x1;
+		top    = sprite->y > rect->y1 ? sprite->y : rect->y1;
+		right  = sprite->x + sprite->width - 1;
+		bottom = sprite->y + sprite->height - 1;
+		if(right > rect->x2)  right = rect->x2;
+		if(bottom > rect->y2) bottom = rect->y2;
+		if((left > right) || (top > bottom)) continue;
+	
+		for(y = top; y <= bottom; y++)
+			lcdst_blendRow(compositor->scratch
+						   + ((y - rect->y1) * w + (left - rect->x1)) * 4,
+						   sprite->pixels + ((y - sprite->y) * sprite->width
+						   + (left - sprite->x)) * 4, right - left + 1,
+						   sprite->alpha);
+	}
+} /* composeRegion */
+
+uint8 lcdst_composeOn(lcdst_t *display, lcdst_compositor_t *compositor)
+{
+	lcdst_sprite_t *order[ST7735S_CFG_SPRITES];
+	unsigned int count = sortSprites(compositor, order), i;
+	lcdst_rect_t rect;
+	uint8 error = 0;
+	
+	for(i = 0; i < compositor->dirtyCount; i++)
+	{
+		/* Send only in the display space */
+		rect = compositor->dirty[i];
+		if((rect.x1 >= display->width) || (rect.y1 >= display->height))
+			continue;
+		if(rect.x2 >= display->width)  rect.x2 = display->width - 1;
+		if(rect.y2 >= display->height) rect.y2 = display->height - 1;
+	
+		composeRegion(compositor, &rect, order, count);
+		error |= lcdst_blitOn(display, rect.x1, rect.y1, rect.x2 - rect.x1 + 1,
+							  rect.y2 - rect.y1 + 1, compositor->scratch, 0,
+							  ST7735S_SRC_RGBA8888);
+	}
+	compositor->dirtyCount = 0;
+	
+	return error;
+} /* lcdst_composeOn */
+
+uint8 lcdst_compose(lcdst_compositor_t *compositor)
+{
+	return lcdst_composeOn(lcdst_getActiveDisplay(), compositor);
+} /* lcdst_compose */
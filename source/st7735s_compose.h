@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#ifndef _LIBRARY_ST7735S_COMPOSE_
+#define _LIBRARY_ST7735S_COMPOSE_
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The compositor keeps the background layer and the sprites above it.
+ * The changes of the layers only mark the changed regions; lcdst_compose()
+ * blends the layers in these regions and sends them as the rectangles,
+ * so moving a small sprite sends only its old and new place.
+ *
+ * The display must not be drawn by the other functions in the space
+ * of the compositor, because the compositor does not read the display.
+ */
+
+/* The sprite; Change it only with the functions below */
+typedef struct
+{
+	const uint8 *pixels;           /* RGBA8888; NULL = the free place */
+	int x, y;                      /* The position; It can be outside */
+	uint8 width, height;           /* The size of the sprite */
+	uint8 alpha;                   /* The global alpha; 0 to 255 */
+	uint8 visible;                 /* 0 = hidden; 1 = visible */
+	int z;                         /* The order; The higher is above */
+	unsigned int serial;           /* The order of the addition */
+} lcdst_sprite_t;
+
+/* The compositor of one display space */
+typedef struct
+{
+	uint8 width, height;           /* The size of the space */
+	uint8 *background;             /* The background layer; RGBA8888 */
+	uint8 *scratch;                /* The composed region; RGBA8888 */
+	lcdst_sprite_t sprites[ST7735S_CFG_SPRITES];
+	unsigned int serial;           /* The serial of the next sprite */
+	lcdst_rect_t dirty[ST7735S_CFG_DIRTY + 1]; /* One spare place */
+	uint8 dirtyCount;
+} lcdst_compositor_t;
+
+/*
+ * Create the compositor with the black background. The first composing
+ * sends the whole space.
+ *
+ * Parameters:
+ *   width - The width of the space; Usually the width of the display.
+ *   height - The height of the space; Usually the height of the display.
+ *
+ * Return: Pointer to the compositor; NULL if the size is 0.
+ */
+lcdst_compositor_t *lcdst_createCompositor(uint8 width, uint8 height);
+
+/*
+ * Free the compositor. The pixels of the sprites are not freed.
+ *
+ * Parameters:
+ *   compositor - Pointer to the compositor.
+ *
+ * Return: void
+ */
+void lcdst_destroyCompositor(lcdst_compositor_t *compositor);
+
+/*
+ * Copy the bitmap to the background layer, like lcdst_blit() does
+ * on the display. The part outside the space is not copied.
+ *
+ * Parameters:
+ *   compositor - Pointer to the compositor.
+ *   x - Parameter X of the upper left corner.
+ *   y - Parameter Y of the upper left corner.
+ *   w - The width of the bitmap.
+ *   h - The height of the bitmap.
+ *   src - Pointer to the first pixel of the bitmap.
+ *   stride - The distance between the rows in bytes. 0 = packed rows.
+ *   srcFormat - Choose one: ST7735S_SRC_RGB888, ST7735S_SRC_BGR888,
+ *               ST7735S_SRC_RGBA8888 or ST7735S_SRC_RGB565.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_setBackground(lcdst_compositor_t *compositor, uint8 x, uint8 y,
+						  uint8 w, uint8 h, const void *src,
+						  unsigned int stride, uint8 srcFormat);
+
+/*
+ * Add the hidden sprite at the position 0, 0. The pixels are not copied,
+ * so they must be valid until the sprite is removed. The sprites with
+ * the same order are drawn in the order of the addition.
+ *
+ * Parameters:
+ *   compositor - Pointer to the compositor.
+ *   pixels - The RGBA8888 pixels of the sprite; The rows are packed.
+ *   w - The width of the sprite.
+ *   h - The height of the sprite.
+ *   z - The order of the sprite; The higher is above.
+ *
+ * Return: Pointer to the sprite; NULL if there is no free place
+ *         or the sprite is empty.
+ */
+lcdst_sprite_t *lcdst_addSprite(lcdst_compositor_t *compositor,
+								const uint8 *pixels, uint8 w, uint8 h, int z);
+
+/*
+ * Remove the sprite; Its place is composed again.
+ *
+ * Parameters:
+ *   compositor - Pointer to the compositor.
+ *   sprite - Pointer to the sprite.
+ *
+ * Return: void
+ */
+void lcdst_removeSprite(lcdst_compositor_t *compositor,
+						lcdst_sprite_t *sprite);
+
+/*
+ * Change the sprite. Every function marks the old and the new place
+ * of the sprite, if it is visible.
+ *
+ * moveSprite - Move the upper left corner to x, y.
+ * showSprite - Show (state = 1) or hide (state = 0) the sprite.
+ * setSpriteAlpha - Set the global alpha; 0 = transparent; 255 = opaque.
+ * setSpriteOrder - Set the order z; The higher is above.
+ * setSpritePixels - Set the new pixels of the same size, or mark
+ *                   the changed pixels with the same pointer.
+ */
+void lcdst_moveSprite(lcdst_compositor_t *compositor, lcdst_sprite_t *sprite,
+					  int x, int y);
+void lcdst_showSprite(lcdst_compositor_t *compositor, lcdst_sprite_t *sprite,
+					  uint8 state);
+void lcdst_setSpriteAlpha(lcdst_compositor_t *compositor,
+						  lcdst_sprite_t *sprite, uint8 alpha);
+void lcdst_setSpriteOrder(lcdst_compositor_t *compositor,
+						  lcdst_sprite_t *sprite, int z);
+void lcdst_setSpritePixels(lcdst_compositor_t *compositor,
+						   lcdst_sprite_t *sprite, const uint8 *pixels);
+
+/*
+ * Compose the marked regions on the currently active display and send
+ * them like with lcdst_blit(). The part outside the display is not sent.
+ *
+ * Parameters:
+ *   compositor - Pointer to the compositor.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_compose(lcdst_compositor_t *compositor);
+
+/* The function on the specified display, like in st7735s.h */
+uint8 lcdst_composeOn(lcdst_t *display, lcdst_compositor_t *compositor);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_COMPOSE_ */
@@ -0,0 +1,1089 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <string.h>
+#include "st7735s_convert.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define USE_NEON 1
+#elif defined(__AVX2__)
+	#include <immintrin.h>
+	#define USE_AVX2 1
+	#define USE_SSE2 1
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+	#define USE_SSE2 1
+#endif
+
+/*
+ * The kernels are made from the generic steps, which switch on the formats;
+ * The steps must be inlined to drop the switches and the spills.
+ */
+#define STEP static inline __attribute__((always_inline))
+
+/********************************* SCALAR CODE ********************************/
+
+/*
+ * Read one source pixel as 8-bit color intensities.
+ * The RGB565 pixel is stored in the little-endian order.
+ */
+STEP void loadPx(uint8 srcFormat, const uint8 *src,
+				 uint8 *r, uint8 *g, uint8 *b)
+{
+	unsigned int v;
+	
+	switch(srcFormat)
+	{
+		case ST7735S_SRC_BGR888:
+			*r = src[2]; *g = src[1]; *b = src[0];
+			break;
+	
+		case ST7735S_SRC_RGB565:
+			v = src[0] | (src[1] << 8);
+			*r = ((v >> 8) & 0xF8) | (v >> 13);
+			*g = ((v >> 3) & 0xFC) | ((v >> 9) & 0x03);
+			*b = ((v << 3) & 0xF8) | ((v >> 2) & 0x07);
+			break;
+	
+		default: /* RGB888 and RGBA8888 */
+			*r = src[0]; *g = src[1]; *b = src[2];
+			break;
+	}
+} /* loadPx */
+
+static inline void scalarFull(uint8 *dst, const uint8 *src,
+							  unsigned int count, uint8 srcFormat)
+{
+	unsigned int size = lcdst_getSourceSize(srcFormat);
+	
+	for(; count; count--, src += size, dst += 3)
+		loadPx(srcFormat, src, dst, dst + 1, dst + 2);
+} /* scalarFull */
+
+static inline void scalarMedium(uint8 *dst, const uint8 *src,
+								unsigned int count, uint8 srcFormat)
+{
+	unsigned int size = lcdst_getSourceSize(srcFormat);
+	uint8 r, g, b;
+	
+	for(; count; count--, src += size, dst += 2)
+	{
+		loadPx(srcFormat, src, &r, &g, &b);
+		dst[0] = (r & 0xF8) | (g >> 5);
+		dst[1] = ((g << 3) & 0xE0) | (b >> 3);
+	}
+} /* scalarMedium */
+
+static inline void scalarReduced(uint8 *dst, const uint8 *src,
+								 unsigned int count, uint8 srcFormat)
+{
+	unsigned int size = lcdst_getSourceSize(srcFormat);
+	uint8 r, g, b, rr, gg, bb;
+	
+	for(; count >= 2; count -= 2, src += size * 2, dst += 3)
+	{
+		loadPx(srcFormat, src, &r, &g, &b);
+		loadPx(srcFormat, src + size, &rr, &gg, &bb);
+		dst[0] = (r & 0xF0) | (g >> 4);
+		dst[1] = (b & 0xF0) | (rr >> 4);
+		dst[2] = (gg & 0xF0) | (bb >> 4);
+	}
+} /* scalarReduced */
+
+/*
+ * The 4x4 Bayer matrix; The thresholds from 0 to 15.
+ */
+static const uint8 bayer[4][4] =
+{
+	{ 0,  8,  2, 10},
+	{12,  4, 14,  6},
+	{ 3, 11,  1,  9},
+	{15,  7, 13,  5}
+};
+
+/*
+ * Get the number of bits of the color components in the pixel size.
+ *
+ * Return: The bits of red, green and blue; 0 for the full pixel size.
+ */
+static inline unsigned int componentBits(uint8 pixel, unsigned int component)
+{
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  return (component == 1) ? 6 : 5;
+		case ST7735S_PIXEL_REDUCED: return 4;
+		default:                    return 0;
+	}
+} /* componentBits */
+
+/*
+ * Scale the intensities to the levels of the pixel size and add the
+ * thresholds; v - (v >> bits) + t. The truncation by the kernel rounds them
+ * to the levels, which the display shows as (level * 255 / maximum).
+ *
+ * Parameters:
+ *   row - The intensities.
+ *   thresholds - The pattern of 48 thresholds; Less than the level step.
+ *   shifts - The pattern of 48 bits of the components.
+ *   length - The number of bytes; The patterns are repeated.
+ */
+static inline void scalarDither(uint8 *row, const uint8 *thresholds,
+								const uint8 *shifts, unsigned int length)
+{
+	unsigned int i, j;
+	
+	for(i = j = 0; i < length; i++, j = (j == 47) ? 0 : j + 1)
+		row[i] = row[i] - (row[i] >> shifts[j]) + thresholds[j];
+} /* scalarDither */
+
+/*
+ * Divide the product of two intensities by 255 with the rounding.
+ */
+static inline unsigned int div255(unsigned int v)
+{
+	v += 128;
+	return (v + (v >> 8)) >> 8;
+} /* div255 */
+
+/*
+ * Blend the RGBA8888 pixels over the RGBA8888 pixels. The alpha
+ * of the source pixel is scaled by the global alpha.
+ */
+static inline void scalarBlend(uint8 *dst, const uint8 *src,
+							   unsigned int count, uint8 alpha)
+{
+	unsigned int a, c;
+	
+	for(; count; count--, dst += 4, src += 4)
+	{
+		a = div255(src[3] * alpha);
+		for(c = 0; c < 4; c++)
+			dst[c] = div255(src[c] * a + dst[c] * (255 - a));
+	}
+} /* scalarBlend */
+
+/*********************************** NEON CODE ********************************/
+#if USE_NEON
+
+/*
+ * Store 16 pixels given as the vectors of color intensities.
+ */
+STEP void neonStore(uint8 pixel, uint8 *dst,
+					uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+	uint8x16x3_t full;
+	uint8x16x2_t medium, ru, gu, bu;
+	uint8x8x3_t reduced;
+	
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:
+			medium.val[0] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)),
+									 vshrq_n_u8(g, 5));
+			medium.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3),
+											  vdupq_n_u8(0xE0)),
+									 vshrq_n_u8(b, 3));
+			vst2q_u8(dst, medium);
+			break;
+	
+		case ST7735S_PIXEL_REDUCED:
+			/* Split the even and the odd pixels of the pairs */
+			ru = vuzpq_u8(r, r);
+			gu = vuzpq_u8(g, g);
+			bu = vuzpq_u8(b, b);
+			reduced.val[0] = vorr_u8(
+				vand_u8(vget_low_u8(ru.val[0]), vdup_n_u8(0xF0)),
+				vshr_n_u8(vget_low_u8(gu.val[0]), 4));
+			reduced.val[1] = vorr_u8(
+				vand_u8(vget_low_u8(bu.val[0]), vdup_n_u8(0xF0)),
+				vshr_n_u8(vget_low_u8(ru.val[1]), 4));
+			reduced.val[2] = vorr_u8(
+				vand_u8(vget_low_u8(gu.val[1]), vdup_n_u8(0xF0)),
+				vshr_n_u8(vget_low_u8(bu.val[1]), 4));
+			vst3_u8(dst, reduced);
+			break;
+	
+		default:
+			full.val[0] = r; full.val[1] = g; full.val[2] = b;
+			vst3q_u8(dst, full);
+			break;
+	}
+} /* neonStore */
+
+/*
+ * Load 16 source pixels as the vectors of color intensities.
+ */
+STEP void neonLoad(uint8 srcFormat, const uint8 *src,
+				   uint8x16_t *r, uint8x16_t *g, uint8x16_t *b)
+{
+	uint8x16x3_t rgb;
+	uint8x16x4_t rgba;
+	uint16x8_t lo, hi;
+	
+	switch(srcFormat)
+	{
+		case ST7735S_SRC_RGBA8888:
+			rgba = vld4q_u8(src);
+			*r = rgba.val[0]; *g = rgba.val[1]; *b = rgba.val[2];
+			break;
+	
+		case ST7735S_SRC_BGR888:
+			rgb = vld3q_u8(src);
+			*r = rgb.val[2]; *g = rgb.val[1]; *b = rgb.val[0];
+			break;
+	
+		case ST7735S_SRC_RGB565:
+			lo = vld1q_u16((const uint16_t *) src);
+			hi = vld1q_u16((const uint16_t *) src + 8);
+			*r = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+			*r = vorrq_u8(vandq_u8(*r, vdupq_n_u8(0xF8)), vshrq_n_u8(*r, 5));
+			*g = vcombine_u8(vshrn_n_u16(lo, 3), vshrn_n_u16(hi, 3));
+			*g = vorrq_u8(vandq_u8(*g, vdupq_n_u8(0xFC)), vshrq_n_u8(*g, 6));
+			*b = vcombine_u8(vmovn_u16(vshlq_n_u16(lo, 3)),
+							 vmovn_u16(vshlq_n_u16(hi, 3)));
+			*b = vorrq_u8(vandq_u8(*b, vdupq_n_u8(0xF8)), vshrq_n_u8(*b, 5));
+			break;
+	
+		default:
+			rgb = vld3q_u8(src);
+			*r = rgb.val[0]; *g = rgb.val[1]; *b = rgb.val[2];
+			break;
+	}
+} /* neonLoad */
+
+/* Define the kernel, which converts 16 pixels per iteration */
+#define NEON_KERNEL(name, srcFormat, pixel, scalar)                          \
+static void name(uint8 *dst, const uint8 *src, unsigned int count)           \
+{                                                                            \
+	unsigned int size = lcdst_getSourceSize(srcFormat);                      \
+	uint8x16_t r, g, b;                                                      \
+	                                                                         \
+	for(; count >= 16; count -= 16, src += size * 16)                        \
+	{                                                                        \
+		neonLoad(srcFormat, src, &r, &g, &b);                                \
+		neonStore(pixel, dst, r, g, b);                                      \
+		dst += (pixel == ST7735S_PIXEL_MEDIUM) ? 32 :                        \
+			   (pixel == ST7735S_PIXEL_REDUCED) ? 24 : 48;                   \
+	}                                                                        \
+	scalar(dst, src, count, srcFormat);                                      \
+}
+
+
+/*
+ * Dither the row with the repeated patterns of 48 bytes, see scalarDither().
+ * The shifts of the bytes are done by the negative left shifts.
+ */
+static void ditherPattern(uint8 *row, const uint8 *thresholds,
+						  const uint8 *shifts, unsigned int length)
+{
+	uint8x16_t v;
+	int8x16_t n;
+	unsigned int i;
+	
+	for(; length >= 48; length -= 48)
+	{
+		for(i = 0; i < 48; i += 16, row += 16)
+		{
+			v = vld1q_u8(row);
+			n = vnegq_s8(vreinterpretq_s8_u8(vld1q_u8(shifts + i)));
+			v = vsubq_u8(v, vshlq_u8(v, n));
+			vst1q_u8(row, vaddq_u8(v, vld1q_u8(thresholds + i)));
+		}
+	}
+	scalarDither(row, thresholds, shifts, length);
+} /* ditherPattern */
+
+/*
+ * Divide the 16-bit products by 255 with the rounding, see div255().
+ */
+static inline uint8x8_t neonDiv255(uint16x8_t v)
+{
+	v = vaddq_u16(v, vdupq_n_u16(128));
+	return vshrn_n_u16(vaddq_u16(v, vshrq_n_u16(v, 8)), 8);
+} /* neonDiv255 */
+
+/*
+ * Blend 8 pixels at once, see scalarBlend(). The loads split
+ * the components, so the alpha is already in its own vector.
+ */
+static void blendPixels(uint8 *dst, const uint8 *src, unsigned int count,
+						uint8 alpha)
+{
+	const uint8x8_t global = vdup_n_u8(alpha);
+	uint8x8_t a, inverse;
+	uint8x8x4_t s, d;
+	unsigned int c;
+	
+	for(; count >= 8; count -= 8, dst += 32, src += 32)
+	{
+		s = vld4_u8(src);
+		d = vld4_u8(dst);
+		a = neonDiv255(vmull_u8(s.val[3], global));
+		inverse = vmvn_u8(a);
+		for(c = 0; c < 4; c++)
+			d.val[c] = neonDiv255(vmlal_u8(vmull_u8(s.val[c], a),
+										   d.val[c], inverse));
+		vst4_u8(dst, d);
+	}
+	scalarBlend(dst, src, count, alpha);
+} /* blendPixels */
+
+#endif /* USE_NEON */
+
+/*********************************** SSE2 CODE ********************************/
+#if USE_SSE2
+
+/*
+ * Convert 4 RGBA8888 pixels in 32-bit lanes to RGB565 in the display order
+ * (the high byte first). The result is in the low 16 bits of the lanes.
+ */
+static inline __m128i sse2Rgba565(__m128i px)
+{
+	__m128i hi = _mm_or_si128(
+		_mm_and_si128(px, _mm_set1_epi32(0xF8)),
+		_mm_and_si128(_mm_srli_epi32(px, 13), _mm_set1_epi32(0x07)));
+	__m128i lo = _mm_or_si128(
+		_mm_and_si128(_mm_slli_epi32(px, 3), _mm_set1_epi32(0xE000)),
+		_mm_and_si128(_mm_srli_epi32(px, 11), _mm_set1_epi32(0x1F00)));
+	
+	/* Bias the values for the signed saturation of the packing */
+	return _mm_sub_epi32(_mm_or_si128(hi, lo), _mm_set1_epi32(0x8000));
+} /* sse2Rgba565 */
+
+static void rgbaMedium(uint8 *dst, const uint8 *src, unsigned int count)
+{
+	const __m128i bias = _mm_set1_epi16((short) 0x8000);
+	__m128i a, b;
+	
+#if USE_AVX2
+	const __m256i bias256 = _mm256_set1_epi16((short) 0x8000);
+	const __m256i hiMask = _mm256_set1_epi32(0xF8), hiBits = _mm256_set1_epi32(0x07);
+	const __m256i loMask = _mm256_set1_epi32(0xE000), loBits = _mm256_set1_epi32(0x1F00);
+	__m256i p, q;
+	
+	for(; count >= 16; count -= 16, src += 64, dst += 32)
+	{
+		p = _mm256_loadu_si256((const __m256i *) src);
+		q = _mm256_loadu_si256((const __m256i *) (src + 32));
+	
+		p = _mm256_or_si256(
+			_mm256_or_si256(_mm256_and_si256(p, hiMask),
+				_mm256_and_si256(_mm256_srli_epi32(p, 13), hiBits)),
+			_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(p, 3), loMask),
+				_mm256_and_si256(_mm256_srli_epi32(p, 11), loBits)));
+		q = _mm256_or_si256(
+			_mm256_or_si256(_mm256_and_si256(q, hiMask),
+				_mm256_and_si256(_mm256_srli_epi32(q, 13), hiBits)),
+			_mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(q, 3), loMask),
+				_mm256_and_si256(_mm256_srli_epi32(q, 11), loBits)));
+	
+		/* The packing works in the 128-bit lanes; Restore the order */
+		p = _mm256_packs_epi32(_mm256_sub_epi32(p, _mm256_set1_epi32(0x8000)),
+							   _mm256_sub_epi32(q, _mm256_set1_epi32(0x8000)));
+		p = _mm256_permute4x64_epi64(_mm256_xor_si256(p, bias256), 0xD8);
+		_mm256_storeu_si256((__m256i *) dst, p);
+	}
+#endif /* USE_AVX2 */
+	
+	for(; count >= 8; count -= 8, src += 32, dst += 16)
+	{
+		a = sse2Rgba565(_mm_loadu_si128((const __m128i *) src));
+		b = sse2Rgba565(_mm_loadu_si128((const __m128i *) (src + 16)));
+		_mm_storeu_si128((__m128i *) dst,
+						 _mm_xor_si128(_mm_packs_epi32(a, b), bias));
+	}
+	
+	scalarMedium(dst, src, count, ST7735S_SRC_RGBA8888);
+} /* rgbaMedium */
+
+static void rgb565Medium(uint8 *dst, const uint8 *src, unsigned int count)
+{
+	__m128i v;
+	
+#if USE_AVX2
+	__m256i w;
+	
+	for(; count >= 16; count -= 16, src += 32, dst += 32)
+	{
+		w = _mm256_loadu_si256((const __m256i *) src);
+		w = _mm256_or_si256(_mm256_slli_epi16(w, 8), _mm256_srli_epi16(w, 8));
+		_mm256_storeu_si256((__m256i *) dst, w);
+	}
+#endif /* USE_AVX2 */
+	
+	/* Swap the bytes; The display wants the high byte first */
+	for(; count >= 8; count -= 8, src += 16, dst += 16)
+	{
+		v = _mm_loadu_si128((const __m128i *) src);
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128((__m128i *) dst, v);
+	}
+	
+	scalarMedium(dst, src, count, ST7735S_SRC_RGB565);
+} /* rgb565Medium */
+
+/*
+ * Split 16 pixels of 3 bytes into the vectors of their bytes. There is
+ * no byte shuffle in SSE2, so every pass of the unpacks takes the next
+ * byte of the pixels; After 4 passes the bytes are in their own vectors.
+ */
+STEP void sse2Split3(const uint8 *src,
+					 __m128i *a, __m128i *b, __m128i *c)
+{
+	__m128i t0 = _mm_loadu_si128((const __m128i *) src);
+	__m128i t1 = _mm_loadu_si128((const __m128i *) (src + 16));
+	__m128i t2 = _mm_loadu_si128((const __m128i *) (src + 32));
+	__m128i u0, u1, u2;
+	unsigned int pass;
+	
+	for(pass = 0; pass < 4; pass++)
+	{
+		u0 = _mm_unpacklo_epi8(t0, _mm_unpackhi_epi64(t1, t1));
+		u1 = _mm_unpacklo_epi8(_mm_unpackhi_epi64(t0, t0), t2);
+		u2 = _mm_unpacklo_epi8(t1, _mm_unpackhi_epi64(t2, t2));
+		t0 = u0; t1 = u1; t2 = u2;
+	}
+	
+	*a = t0; *b = t1; *c = t2;
+} /* sse2Split3 */
+
+/*
+ * Pack 4 pixels of 3 bytes in 32-bit lanes to the low 12 bytes.
+ */
+static inline __m128i sse2Pack3(__m128i v)
+{
+	/* The odd lanes go next to the even lanes, then the halves join */
+	v = _mm_or_si128(_mm_and_si128(v, _mm_set_epi32(0, -1, 0, -1)),
+					 _mm_slli_epi64(_mm_srli_epi64(v, 32), 24));
+	return _mm_or_si128(_mm_move_epi64(v),
+						_mm_slli_si128(_mm_srli_si128(v, 8), 6));
+} /* sse2Pack3 */
+
+/*
+ * Store the bytes of 8 or 16 pixels of 3 bytes from their own vectors.
+ */
+STEP void sse2Store3(uint8 *dst, __m128i a, __m128i b, __m128i c,
+					 unsigned int count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i ab = _mm_unpacklo_epi8(a, b), cz = _mm_unpacklo_epi8(c, zero);
+	__m128i p0 = sse2Pack3(_mm_unpacklo_epi16(ab, cz));
+	__m128i p1 = sse2Pack3(_mm_unpackhi_epi16(ab, cz));
+	__m128i p2, p3;
+	
+	_mm_storeu_si128((__m128i *) dst, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+	if(count == 8)
+	{
+		_mm_storel_epi64((__m128i *) (dst + 16), _mm_srli_si128(p1, 4));
+		return;
+	}
+	
+	ab = _mm_unpackhi_epi8(a, b);
+	cz = _mm_unpackhi_epi8(c, zero);
+	p2 = sse2Pack3(_mm_unpacklo_epi16(ab, cz));
+	p3 = sse2Pack3(_mm_unpackhi_epi16(ab, cz));
+	_mm_storeu_si128((__m128i *) (dst + 16), _mm_or_si128(
+		_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+	_mm_storeu_si128((__m128i *) (dst + 32), _mm_or_si128(
+		_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+} /* sse2Store3 */
+
+/*
+ * Expand the component of 8 RGB565 pixels in 16-bit lanes to 8 bits.
+ */
+static inline __m128i sse2Expand565(__m128i v, int shift, int bits)
+{
+	v = _mm_and_si128(_mm_srli_epi16(v, shift),
+					  _mm_set1_epi16((1 << bits) - 1));
+	return _mm_or_si128(_mm_slli_epi16(v, 8 - bits),
+						_mm_srli_epi16(v, 2 * bits - 8));
+} /* sse2Expand565 */
+
+/*
+ * Load 16 source pixels as the vectors of color intensities.
+ */
+STEP void sse2Load(uint8 srcFormat, const uint8 *src,
+				   __m128i *r, __m128i *g, __m128i *b)
+{
+	const __m128i low = _mm_set1_epi32(0xFF);
+	__m128i v[4], c[3][4];
+	unsigned int i, j;
+	
+	switch(srcFormat)
+	{
+		case ST7735S_SRC_RGBA8888:
+			/* The components are taken from the 32-bit lanes and packed */
+			for(i = 0; i < 4; i++)
+			{
+				v[i] = _mm_loadu_si128((const __m128i *) (src + i * 16));
+				for(j = 0; j < 3; j++)
+					c[j][i] = _mm_and_si128(_mm_srli_epi32(v[i], j * 8), low);
+			}
+			for(j = 0; j < 3; j++)
+				c[j][0] = _mm_packus_epi16(_mm_packs_epi32(c[j][0], c[j][1]),
+										   _mm_packs_epi32(c[j][2], c[j][3]));
+			*r = c[0][0]; *g = c[1][0]; *b = c[2][0];
+			break;
+	
+		case ST7735S_SRC_BGR888:
+			sse2Split3(src, b, g, r);
+			break;
+	
+		case ST7735S_SRC_RGB565:
+			v[0] = _mm_loadu_si128((const __m128i *) src);
+			v[1] = _mm_loadu_si128((const __m128i *) (src + 16));
+			*r = _mm_packus_epi16(sse2Expand565(v[0], 11, 5),
+								  sse2Expand565(v[1], 11, 5));
+			*g = _mm_packus_epi16(sse2Expand565(v[0], 5, 6),
+								  sse2Expand565(v[1], 5, 6));
+			*b = _mm_packus_epi16(sse2Expand565(v[0], 0, 5),
+								  sse2Expand565(v[1], 0, 5));
+			break;
+	
+		default:
+			sse2Split3(src, r, g, b);
+			break;
+	}
+} /* sse2Load */
+
+/*
+ * Store 16 pixels given as the vectors of color intensities.
+ * There are no byte shifts, so the 16-bit shifts are masked.
+ */
+STEP void sse2Store(uint8 pixel, uint8 *dst,
+					__m128i r, __m128i g, __m128i b)
+{
+	const __m128i even = _mm_set1_epi16(0xFF), high = _mm_set1_epi16(0xF0);
+	__m128i hi, lo, x, y, z;
+	
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:
+			hi = _mm_or_si128(_mm_and_si128(r, _mm_set1_epi8(0xF8)),
+				_mm_and_si128(_mm_srli_epi16(g, 5), _mm_set1_epi8(0x07)));
+			lo = _mm_or_si128(
+				_mm_and_si128(_mm_slli_epi16(g, 3), _mm_set1_epi8(0xE0)),
+				_mm_and_si128(_mm_srli_epi16(b, 3), _mm_set1_epi8(0x1F)));
+			_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi8(hi, lo));
+			_mm_storeu_si128((__m128i *) (dst + 16), _mm_unpackhi_epi8(hi, lo));
+			break;
+	
+		case ST7735S_PIXEL_REDUCED:
+			/* The pairs in 16-bit lanes; The even pixel in the low byte */
+			x = _mm_or_si128(_mm_and_si128(r, high),
+							 _mm_srli_epi16(_mm_and_si128(g, even), 4));
+			y = _mm_or_si128(_mm_and_si128(b, high), _mm_srli_epi16(r, 12));
+			z = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(g, 8), high),
+							 _mm_srli_epi16(b, 12));
+			sse2Store3(dst, _mm_packus_epi16(x, x), _mm_packus_epi16(y, y),
+					   _mm_packus_epi16(z, z), 8);
+			break;
+	
+		default:
+			sse2Store3(dst, r, g, b, 16);
+			break;
+	}
+} /* sse2Store */
+
+#if USE_AVX2
+
+/*
+ * The AVX2 code converts the sources of 3 bytes and blends the pixels;
+ * The other sources and ditherPattern() use the SSE2 code, except
+ * the AVX2 loops of rgbaMedium() and rgb565Medium().
+ *
+ * The shuffles of the bytes of 16 pixels of 3 bytes; The first index is
+ * the result, the second is the source vector; -1 is the zero byte.
+ * The split takes the bytes of the pixels to their own vectors and the
+ * merge takes them back.
+ */
+static const signed char splitMasks[3][3][16] =
+{
+	{{ 0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  1,  4,  7, 10, 13}},
+	{{ 1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  2,  5,  8, 11, 14}},
+	{{ 2,  5,  8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1,  1,  4,  7, 10, 13, -1, -1, -1, -1, -1, -1},
+	 {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  0,  3,  6,  9, 12, 15}}
+};
+
+static const signed char mergeMasks[3][3][16] =
+{
+	{{ 0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1,  5},
+	 {-1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1, -1},
+	 {-1, -1,  0, -1, -1,  1, -1, -1,  2, -1, -1,  3, -1, -1,  4, -1}},
+	{{-1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10, -1},
+	 { 5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1, 10},
+	 {-1,  5, -1, -1,  6, -1, -1,  7, -1, -1,  8, -1, -1,  9, -1, -1}},
+	{{-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1},
+	 {-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1},
+	 {10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15}}
+};
+
+/*
+ * Take every byte of the result from one of 3 vectors by the masks.
+ * The shuffles work in the 128-bit lanes; Both lanes use the same masks.
+ */
+STEP __m256i avx2Gather3(__m256i t0, __m256i t1, __m256i t2,
+						 const signed char masks[3][16])
+{
+	__m256i m0 = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i *) masks[0]));
+	__m256i m1 = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i *) masks[1]));
+	__m256i m2 = _mm256_broadcastsi128_si256(
+		_mm_loadu_si128((const __m128i *) masks[2]));
+	
+	return _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(t0, m0),
+		_mm256_shuffle_epi8(t1, m1)), _mm256_shuffle_epi8(t2, m2));
+} /* avx2Gather3 */
+
+/* Load 2 blocks of 16 bytes to the lanes */
+STEP __m256i avx2Load2(const uint8 *lo, const uint8 *hi)
+{
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(
+		_mm_loadu_si128((const __m128i *) lo)),
+		_mm_loadu_si128((const __m128i *) hi), 1);
+} /* avx2Load2 */
+
+/*
+ * Split 32 pixels of 3 bytes into the vectors of their bytes.
+ * The low lanes have the first 16 pixels.
+ */
+STEP void avx2Split3(const uint8 *src, __m256i *a, __m256i *b, __m256i *c)
+{
+	__m256i t0 = avx2Load2(src, src + 48);
+	__m256i t1 = avx2Load2(src + 16, src + 64);
+	__m256i t2 = avx2Load2(src + 32, src + 80);
+	
+	*a = avx2Gather3(t0, t1, t2, splitMasks[0]);
+	*b = avx2Gather3(t0, t1, t2, splitMasks[1]);
+	*c = avx2Gather3(t0, t1, t2, splitMasks[2]);
+} /* avx2Split3 */
+
+/*
+ * Store the bytes of 16 or 32 pixels of 3 bytes from their own vectors.
+ * The low lanes have the first 16 pixels.
+ */
+STEP void avx2Store3(uint8 *dst, __m256i a, __m256i b, __m256i c,
+					 unsigned int count)
+{
+	__m256i o0 = avx2Gather3(a, b, c, mergeMasks[0]);
+	__m256i o1 = avx2Gather3(a, b, c, mergeMasks[1]);
+	__m256i o2 = avx2Gather3(a, b, c, mergeMasks[2]);
+	
+	if(count == 16)
+	{
+		_mm_storeu_si128((__m128i *) dst, _mm256_castsi256_si128(o0));
+		_mm_storeu_si128((__m128i *) (dst + 16), _mm256_castsi256_si128(o1));
+		_mm_storeu_si128((__m128i *) (dst + 32), _mm256_castsi256_si128(o2));
+		return;
+	}
+	
+	_mm256_storeu_si256((__m256i *) dst,
+						_mm256_permute2x128_si256(o0, o1, 0x20));
+	_mm256_storeu_si256((__m256i *) (dst + 32),
+						_mm256_permute2x128_si256(o2, o0, 0x30));
+	_mm256_storeu_si256((__m256i *) (dst + 64),
+						_mm256_permute2x128_si256(o1, o2, 0x31));
+} /* avx2Store3 */
+
+/*
+ * Pack the 16-bit lanes to the bytes in the order of the pixels.
+ * The packing works in the 128-bit lanes; The even quarters are taken.
+ */
+STEP __m256i avx2Pack(__m256i v)
+{
+	return _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+} /* avx2Pack */
+
+/*
+ * Convert 32 pixels of 3 bytes per iteration with the same steps
+ * as sse2Store(); The other sources are left to the SSE2 code.
+ *
+ * Return: The number of the remaining pixels; The pointers are moved.
+ */
+STEP unsigned int avx2Convert(uint8 srcFormat, uint8 pixel,
+							  uint8 **dst, const uint8 **src,
+							  unsigned int count)
+{
+	const __m256i even = _mm256_set1_epi16(0xFF);
+	const __m256i high = _mm256_set1_epi16(0xF0);
+	__m256i r, g, b, hi, lo, x, y, z;
+	
+	if((srcFormat != ST7735S_SRC_RGB888) && (srcFormat != ST7735S_SRC_BGR888))
+		return count;
+	
+	for(; count >= 32; count -= 32, *src += 96)
+	{
+		if(srcFormat == ST7735S_SRC_BGR888) avx2Split3(*src, &b, &g, &r);
+		else avx2Split3(*src, &r, &g, &b);
+	
+		switch(pixel)
+		{
+			case ST7735S_PIXEL_MEDIUM:
+				hi = _mm256_or_si256(
+					_mm256_and_si256(r, _mm256_set1_epi8(0xF8)),
+					_mm256_and_si256(_mm256_srli_epi16(g, 5),
+									 _mm256_set1_epi8(0x07)));
+				lo = _mm256_or_si256(
+					_mm256_and_si256(_mm256_slli_epi16(g, 3),
+									 _mm256_set1_epi8(0xE0)),
+					_mm256_and_si256(_mm256_srli_epi16(b, 3),
+									 _mm256_set1_epi8(0x1F)));
+				x = _mm256_unpacklo_epi8(hi, lo);
+				y = _mm256_unpackhi_epi8(hi, lo);
+				_mm256_storeu_si256((__m256i *) *dst,
+									_mm256_permute2x128_si256(x, y, 0x20));
+				_mm256_storeu_si256((__m256i *) (*dst + 32),
+									_mm256_permute2x128_si256(x, y, 0x31));
+				*dst += 64;
+				break;
+	
+			case ST7735S_PIXEL_REDUCED:
+				x = _mm256_or_si256(_mm256_and_si256(r, high),
+					_mm256_srli_epi16(_mm256_and_si256(g, even), 4));
+				y = _mm256_or_si256(_mm256_and_si256(b, high),
+									_mm256_srli_epi16(r, 12));
+				z = _mm256_or_si256(
+					_mm256_and_si256(_mm256_srli_epi16(g, 8), high),
+					_mm256_srli_epi16(b, 12));
+				avx2Store3(*dst, avx2Pack(x), avx2Pack(y), avx2Pack(z), 16);
+				*dst += 48;
+				break;
+	
+			default:
+				avx2Store3(*dst, r, g, b, 32);
+				*dst += 96;
+				break;
+		}
+	}
+	return count;
+} /* avx2Convert */
+
+#else
+	#define avx2Convert(srcFormat, pixel, dst, src, count) (count)
+#endif /* USE_AVX2 */
+
+/* Define the kernel, which converts 16 pixels per iteration */
+#define SSE2_KERNEL(name, srcFormat, pixel, scalar)                          \
+static void name(uint8 *dst, const uint8 *src, unsigned int count)           \
+{                                                                            \
+	unsigned int size = lcdst_getSourceSize(srcFormat);                      \
+	__m128i r, g, b;                                                         \
+	                                                                         \
+	count = avx2Convert(srcFormat, pixel, &dst, &src, count);                \
+	for(; count >= 16; count -= 16, src += size * 16)                        \
+	{                                                                        \
+		sse2Load(srcFormat, src, &r, &g, &b);                                \
+		sse2Store(pixel, dst, r, g, b);                                      \
+		dst += (pixel == ST7735S_PIXEL_MEDIUM) ? 32 :                        \
+			   (pixel == ST7735S_PIXEL_REDUCED) ? 24 : 48;                   \
+	}                                                                        \
+	scalar(dst, src, count, srcFormat);                                      \
+}
+
+
+/*
+ * Dither the row with the repeated patterns of 48 bytes, see scalarDither().
+ * There are no shifts of the bytes; The words are shifted by both shifts
+ * of the components and the results are selected by the byte.
+ */
+static void ditherPattern(uint8 *row, const uint8 *thresholds,
+						  const uint8 *shifts, unsigned int length)
+{
+	const __m128i countA = _mm_cvtsi32_si128(shifts[0]);
+	const __m128i countB = _mm_cvtsi32_si128(shifts[1]);
+	const __m128i maskA = _mm_set1_epi8(0xFF >> shifts[0]);
+	const __m128i maskB = _mm_set1_epi8(0xFF >> shifts[1]);
+	const __m128i green = _mm_set1_epi8(shifts[1]);
+	__m128i v, a, b, select;
+	unsigned int i;
+	
+	for(; length >= 48; length -= 48)
+	{
+		for(i = 0; i < 48; i += 16, row += 16)
+		{
+			v = _mm_loadu_si128((const __m128i *) row);
+			a = _mm_and_si128(_mm_srl_epi16(v, countA), maskA);
+			b = _mm_and_si128(_mm_srl_epi16(v, countB), maskB);
+			select = _mm_cmpeq_epi8(
+				_mm_loadu_si128((const __m128i *) (shifts + i)), green);
+			a = _mm_or_si128(_mm_andnot_si128(select, a),
+							 _mm_and_si128(select, b));
+			v = _mm_add_epi8(_mm_sub_epi8(v, a), _mm_loadu_si128(
+				(const __m128i *) (thresholds + i)));
+			_mm_storeu_si128((__m128i *) row, v);
+		}
+	}
+	scalarDither(row, thresholds, shifts, length);
+} /* ditherPattern */
+
+/*
+ * Divide the 16-bit products by 255 with the rounding, see div255().
+ * The sums do not exceed 65407, so the unsigned wrap does not occur.
+ */
+static inline __m128i sse2Div255(__m128i v)
+{
+	v = _mm_add_epi16(v, _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+} /* sse2Div255 */
+
+/*
+ * Blend 2 pixels in 16-bit lanes; The alpha is copied to all lanes
+ * of its pixel by the shuffles.
+ */
+static inline __m128i sse2Blend(__m128i s, __m128i d, __m128i global)
+{
+	__m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+	
+	a = sse2Div255(_mm_mullo_epi16(a, global));
+	return sse2Div255(_mm_add_epi16(_mm_mullo_epi16(s, a), _mm_mullo_epi16(
+		d, _mm_sub_epi16(_mm_set1_epi16(255), a))));
+} /* sse2Blend */
+
+#if USE_AVX2
+/* The same steps as sse2Div255() and sse2Blend() in the 256-bit vectors */
+static inline __m256i avx2Div255(__m256i v)
+{
+	v = _mm256_add_epi16(v, _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+} /* avx2Div255 */
+
+static inline __m256i avx2Blend(__m256i s, __m256i d, __m256i global)
+{
+	__m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+	
+	a = avx2Div255(_mm256_mullo_epi16(a, global));
+	return avx2Div255(_mm256_add_epi16(_mm256_mullo_epi16(s, a),
+		_mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a))));
+} /* avx2Blend */
+#endif /* USE_AVX2 */
+
+/* Blend 4 pixels at once, see scalarBlend() */
+static void blendPixels(uint8 *dst, const uint8 *src, unsigned int count,
+						uint8 alpha)
+{
+	const __m128i zero = _mm_setzero_si128(), global = _mm_set1_epi16(alpha);
+	__m128i s, d, lo, hi;
+	
+#if USE_AVX2
+	const __m256i zero256 = _mm256_setzero_si256();
+	const __m256i global256 = _mm256_set1_epi16(alpha);
+	__m256i s8, d8;
+	
+	/* The unpacking and the packing work in the same 128-bit lanes */
+	for(; count >= 8; count -= 8, dst += 32, src += 32)
+	{
+		s8 = _mm256_loadu_si256((const __m256i *) src);
+		d8 = _mm256_loadu_si256((const __m256i *) dst);
+		_mm256_storeu_si256((__m256i *) dst, _mm256_packus_epi16(
+			avx2Blend(_mm256_unpacklo_epi8(s8, zero256),
+					  _mm256_unpacklo_epi8(d8, zero256), global256),
+			avx2Blend(_mm256_unpackhi_epi8(s8, zero256),
+					  _mm256_unpackhi_epi8(d8, zero256), global256)));
+	}
+#endif /* USE_AVX2 */
+	
+	for(; count >= 4; count -= 4, dst += 16, src += 16)
+	{
+		s = _mm_loadu_si128((const __m128i *) src);
+		d = _mm_loadu_si128((const __m128i *) dst);
+		lo = sse2Blend(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero),
+					   global);
+		hi = sse2Blend(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero),
+					   global);
+		_mm_storeu_si128((__m128i *) dst, _mm_packus_epi16(lo, hi));
+	}
+	scalarBlend(dst, src, count, alpha);
+} /* blendPixels */
+
+#endif /* USE_SSE2 */
+
+/********************************* THE KERNELS ********************************/
+
+/* Define the kernel, which uses only the scalar code */
+#define SCALAR_KERNEL(name, srcFormat, scalar)                               \
+static void name(uint8 *dst, const uint8 *src, unsigned int count)           \
+{                                                                            \
+	scalar(dst, src, count, srcFormat);                                      \
+}
+
+/* The source is already in the 18-bit order */
+static void rgbFull(uint8 *dst, const uint8 *src, unsigned int count)
+{
+	memcpy(dst, src, count * 3);
+} /* rgbFull */
+
+#if USE_NEON
+NEON_KERNEL(bgrFull,       ST7735S_SRC_BGR888,   ST7735S_PIXEL_FULL,    scalarFull)
+NEON_KERNEL(rgbaFull,      ST7735S_SRC_RGBA8888, ST7735S_PIXEL_FULL,    scalarFull)
+NEON_KERNEL(rgb565Full,    ST7735S_SRC_RGB565,   ST7735S_PIXEL_FULL,    scalarFull)
+NEON_KERNEL(rgbMedium,     ST7735S_SRC_RGB888,   ST7735S_PIXEL_MEDIUM,  scalarMedium)
+NEON_KERNEL(bgrMedium,     ST7735S_SRC_BGR888,   ST7735S_PIXEL_MEDIUM,  scalarMedium)
+NEON_KERNEL(rgbaMedium,    ST7735S_SRC_RGBA8888, ST7735S_PIXEL_MEDIUM,  scalarMedium)
+NEON_KERNEL(rgb565Medium,  ST7735S_SRC_RGB565,   ST7735S_PIXEL_MEDIUM,  scalarMedium)
+NEON_KERNEL(rgbReduced,    ST7735S_SRC_RGB888,   ST7735S_PIXEL_REDUCED, scalarReduced)
+NEON_KERNEL(bgrReduced,    ST7735S_SRC_BGR888,   ST7735S_PIXEL_REDUCED, scalarReduced)
+NEON_KERNEL(rgbaReduced,   ST7735S_SRC_RGBA8888, ST7735S_PIXEL_REDUCED, scalarReduced)
+NEON_KERNEL(rgb565Reduced, ST7735S_SRC_RGB565,   ST7735S_PIXEL_REDUCED, scalarReduced)
+#elif USE_SSE2
+SSE2_KERNEL(bgrFull,       ST7735S_SRC_BGR888,   ST7735S_PIXEL_FULL,    scalarFull)
+SSE2_KERNEL(rgbaFull,      ST7735S_SRC_RGBA8888, ST7735S_PIXEL_FULL,    scalarFull)
+SSE2_KERNEL(rgb565Full,    ST7735S_SRC_RGB565,   ST7735S_PIXEL_FULL,    scalarFull)
+SSE2_KERNEL(rgbMedium,     ST7735S_SRC_RGB888,   ST7735S_PIXEL_MEDIUM,  scalarMedium)
+SSE2_KERNEL(bgrMedium,     ST7735S_SRC_BGR888,   ST7735S_PIXEL_MEDIUM,  scalarMedium)
+SSE2_KERNEL(rgbReduced,    ST7735S_SRC_RGB888,   ST7735S_PIXEL_REDUCED, scalarReduced)
+SSE2_KERNEL(bgrReduced,    ST7735S_SRC_BGR888,   ST7735S_PIXEL_REDUCED, scalarReduced)
+SSE2_KERNEL(rgbaReduced,   ST7735S_SRC_RGBA8888, ST7735S_PIXEL_REDUCED, scalarReduced)
+SSE2_KERNEL(rgb565Reduced, ST7735S_SRC_RGB565,   ST7735S_PIXEL_REDUCED, scalarReduced)
+#else
+SCALAR_KERNEL(bgrFull,       ST7735S_SRC_BGR888,   scalarFull)
+SCALAR_KERNEL(rgbaFull,      ST7735S_SRC_RGBA8888, scalarFull)
+SCALAR_KERNEL(rgb565Full,    ST7735S_SRC_RGB565,   scalarFull)
+SCALAR_KERNEL(rgbMedium,     ST7735S_SRC_RGB888,   scalarMedium)
+SCALAR_KERNEL(bgrMedium,     ST7735S_SRC_BGR888,   scalarMedium)
+SCALAR_KERNEL(rgbaMedium,    ST7735S_SRC_RGBA8888, scalarMedium)
+SCALAR_KERNEL(rgb565Medium,  ST7735S_SRC_RGB565,   scalarMedium)
+SCALAR_KERNEL(rgbReduced,    ST7735S_SRC_RGB888,   scalarReduced)
+SCALAR_KERNEL(bgrReduced,    ST7735S_SRC_BGR888,   scalarReduced)
+SCALAR_KERNEL(rgbaReduced,   ST7735S_SRC_RGBA8888, scalarReduced)
+SCALAR_KERNEL(rgb565Reduced, ST7735S_SRC_RGB565,   scalarReduced)
+#endif
+
+/* The kernels; [source format][pixel size] */
+static const lcdst_convert_t converters[4][3] =
+{
+	/* REDUCED        FULL        MEDIUM */
+	{rgbReduced,    rgbFull,    rgbMedium},    /* ST7735S_SRC_RGB888 */
+	{bgrReduced,    bgrFull,    bgrMedium},    /* ST7735S_SRC_BGR888 */
+	{rgbaReduced,   rgbaFull,   rgbaMedium},   /* ST7735S_SRC_RGBA8888 */
+	{rgb565Reduced, rgb565Full, rgb565Medium}  /* ST7735S_SRC_RGB565 */
+};
+
+lcdst_convert_t lcdst_getConverter(uint8 srcFormat, uint8 pixel)
+{
+	if((srcFormat > ST7735S_SRC_RGB565) || (pixel > ST7735S_PIXEL_MEDIUM))
+		return NULL;
+	
+	return converters[srcFormat][pixel];
+} /* lcdst_getConverter */
+
+unsigned int lcdst_getSourceSize(uint8 srcFormat)
+{
+	switch(srcFormat)
+	{
+		case ST7735S_SRC_RGB888:   return 3;
+		case ST7735S_SRC_BGR888:   return 3;
+		case ST7735S_SRC_RGBA8888: return 4;
+		case ST7735S_SRC_RGB565:   return 2;
+		default:                   return 0;
+	}
+} /* lcdst_getSourceSize */
+
+#if !USE_NEON && !USE_SSE2
+static void ditherPattern(uint8 *row, const uint8 *thresholds,
+						  const uint8 *shifts, unsigned int length)
+{
+	scalarDither(row, thresholds, shifts, length);
+} /* ditherPattern */
+
+static void blendPixels(uint8 *dst, const uint8 *src, unsigned int count,
+						uint8 alpha)
+{
+	scalarBlend(dst, src, count, alpha);
+} /* blendPixels */
+#endif
+
+void lcdst_ditherOrdered(uint8 *row, unsigned int count, uint8 pixel,
+						 unsigned int x, unsigned int y)
+{
+	const uint8 *matrix = bayer[y & 3];
+	uint8 thresholds[48], shifts[48];
+	unsigned int i, c, bits;
+	
+	if(pixel == ST7735S_PIXEL_FULL) return;
+	
+	/*
+	 * The patterns of 16 pixels; The threshold is scaled to the step
+	 * of the component, which the kernel truncates.
+	 */
+	for(i = 0; i < 16; i++)
+		for(c = 0; c < 3; c++)
+		{
+			bits = componentBits(pixel, c);
+			thresholds[i * 3 + c] = matrix[(x + i) & 3] >> (bits - 4);
+			shifts[i * 3 + c] = bits;
+		}
+	
+	ditherPattern(row, thresholds, shifts, count * 3);
+} /* lcdst_ditherOrdered */
+
+/*
+ * Round the intensity with the error to the nearest level of the component
+ * and return the new error. The level is expanded like the display shows it.
+ */
+static inline int diffusePx(uint8 *px, int v, unsigned int bits)
+{
+	unsigned int level, maximum = (1u << bits) - 1;
+	
+	if(v < 0) v = 0;
+	if(v > 255) v = 255;
+	
+	level = ((unsigned int) v * maximum + 127) / 255;
+	level = (level << (8 - bits)) | (level >> (2 * bits - 8));
+	*px = level;
+	
+	return v - (int) level;
+} /* diffusePx */
+
+/*
+ * The Floyd-Steinberg error diffusion of the row. The three components
+ * are independent, so they are processed together in every pixel.
+ */
+static inline void diffuseRow(uint8 *row, unsigned int count, short *error,
+							  const unsigned int bits[3])
+{
+	int right[3] = {0, 0, 0}, below[3] = {0, 0, 0}, e;
+	unsigned int i, c;
+	
+	/* error[i + 3] belongs to the component i of the row */
+	for(i = 0; i < count * 3; i += 3)
+		for(c = 0; c < 3; c++)
+		{
+			e = diffusePx(row + i + c, row[i + c] + error[i + c + 3] + right[c],
+						  bits[c]);
+			
+			/* 7/16 right; 3/16, 5/16 and 1/16 to the next row */
+			right[c] = e * 7 / 16;
+			error[i + c] += e * 3 / 16;
+			error[i + c + 3] = e * 5 / 16 + below[c];
+			below[c] = e / 16;
+		}
+} /* diffuseRow */
+
+void lcdst_ditherDiffusion(uint8 *row, unsigned int count, uint8 pixel,
+						   short *error)
+{
+	static const unsigned int medium[3] = {5, 6, 5}, reduced[3] = {4, 4, 4};
+	
+	/* The constant bits let the compiler specialize the rounding */
+	if(pixel == ST7735S_PIXEL_MEDIUM) diffuseRow(row, count, error, medium);
+	if(pixel == ST7735S_PIXEL_REDUCED) diffuseRow(row, count, error, reduced);
+} /* lcdst_ditherDiffusion */
+
+void lcdst_blendRow(uint8 *dst, const uint8 *src, unsigned int count,
+					uint8 alpha)
+{
+	if(alpha == 0) return;
+	blendPixels(dst, src, count, alpha);
+} /* lcdst_blendRow */
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+/*
+ * The color conversion kernels of the ST7735S driver.
+ * This is the internal header, it is not the part of the public API.
+ */
+
+#ifndef _LIBRARY_ST7735S_CONVERT_
+#define _LIBRARY_ST7735S_CONVERT_
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Convert the row of the source pixels to the pixel size of the display.
+ * For the reduced pixel size the count must be even.
+ *
+ * Parameters:
+ *   dst - The destination; 3, 2 or 1.5 bytes per pixel.
+ *   src - The source pixels.
+ *   count - The number of pixels.
+ */
+typedef void (*lcdst_convert_t)(uint8 *dst, const uint8 *src,
+								unsigned int count);
+
+/*
+ * Get the kernel for the source format and the pixel size.
+ * The ST7735S_PIXEL_FULL destination is also the RGB888 format
+ * of the framebuffer.
+ *
+ * Return: The kernel; NULL if the format is unknown.
+ */
+lcdst_convert_t lcdst_getConverter(uint8 srcFormat, uint8 pixel);
+
+/*
+ * Get the number of bytes of one source pixel.
+ *
+ * Return: 2, 3 or 4; 0 if the format is unknown.
+ */
+unsigned int lcdst_getSourceSize(uint8 srcFormat);
+
+/*
+ * Dither the row of the RGB888 pixels in place with the 4x4 Bayer matrix.
+ * The threshold of the pixel depends on its position on the display,
+ * so the neighbouring rows and bitmaps continue the pattern. The result
+ * is truncated by the kernel of the pixel size; The full pixel size
+ * is not changed.
+ *
+ * Parameters:
+ *   row - The pixels; 3 bytes per pixel.
+ *   count - The number of pixels.
+ *   pixel - The pixel size of the display.
+ *   x, y - The position of the first pixel on the display.
+ */
+void lcdst_ditherOrdered(uint8 *row, unsigned int count, uint8 pixel,
+						 unsigned int x, unsigned int y);
+
+/*
+ * Dither the row of the RGB888 pixels in place with the Floyd-Steinberg
+ * error diffusion. Every pixel is rounded to the nearest level of the pixel
+ * size and its error is spread to the next pixel and to the next row.
+ * The full pixel size is not changed.
+ *
+ * Parameters:
+ *   row - The pixels; 3 bytes per pixel.
+ *   count - The number of pixels.
+ *   pixel - The pixel size of the display.
+ *   error - The errors for this row, replaced with the errors for the next
+ *           one; (count + 2) * 3 values, zero before the first row.
+ */
+void lcdst_ditherDiffusion(uint8 *row, unsigned int count, uint8 pixel,
+						   short *error);
+
+/*
+ * Blend the row of the RGBA8888 pixels over the row of the RGBA8888 pixels.
+ * The alpha of every source pixel is multiplied by the global alpha; Both
+ * are 0 for transparent and 255 for opaque. The results are rounded.
+ *
+ * Parameters:
+ *   dst - The destination pixels; 4 bytes per pixel.
+ *   src - The source pixels with the straight alpha; 4 bytes per pixel.
+ *   count - The number of pixels.
+ *   alpha - The global alpha of the source.
+ */
+void lcdst_blendRow(uint8 *dst, const uint8 *src, unsigned int count,
+					uint8 alpha);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_CONVERT_ */
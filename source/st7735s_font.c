@@ -0,0 +1,612 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "st7735s.h"
+
+/* The number of the chains in the hash table of the glyph cache */
+#define GLYPH_BUCKETS 64
+
+/* No entry; The end of the list or of the chain */
+#define NONE -1
+
+/* The cells of the built-in font; 5x7 characters, ASCII from 0x20 to 0x7E */
+static const uint8 font6x8Bitmap[] =
+{
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* ' ' */
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x20, 0x00, /* '!' */
+	0x50, 0x50, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00, /* '"' */
+	0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50, 0x00, /* '#' */
+	0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20, 0x00, /* '$' */
+	0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18, 0x00, /* '%' */
+	0x60, 0x90, 0xA0, 0x40, 0xA8, 0x90, 0x68, 0x00, /* '&' */
+	0x60, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, /* ''' */
+	0x10, 0x20, 0x40, 0x40, 0x40, 0x20, 0x10, 0x00, /* '(' */
+	0x40, 0x20, 0x10, 0x10, 0x10, 0x20, 0x40, 0x00, /* ')' */
+	0x00, 0x50, 0x20, 0xF8, 0x20, 0x50, 0x00, 0x00, /* 0x2A */
+	0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00, 0x00, /* '+' */
+	0x00, 0x00, 0x00, 0x00, 0x60, 0x20, 0x40, 0x00, /* ',' */
+	0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00, 0x00, /* '-' */
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60, 0x00, /* '.' */
+	0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00, 0x00, /* 0x2F */
+	0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70, 0x00, /* '0' */
+	0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, /* '1' */
+	0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8, 0x00, /* '2' */
+	0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70, 0x00, /* '3' */
+	0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10, 0x00, /* '4' */
+	0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70, 0x00, /* '5' */
+	0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70, 0x00, /* '6' */
+	0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40, 0x00, /* '7' */
+	0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70, 0x00, /* '8' */
+	0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60, 0x00, /* '9' */
+	0x00, 0x60, 0x60, 0x00, 0x60, 0x60, 0x00, 0x00, /* ':' */
+	0x00, 0x60, 0x60, 0x00, 0x60, 0x20, 0x40, 0x00, /* ';' */
+	0x08, 0x10, 0x20, 0x40, 0x20, 0x10, 0x08, 0x00, /* '<' */
+	0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00, 0x00, /* '=' */
+	0x80, 0x40, 0x20, 0x10, 0x20, 0x40, 0x80, 0x00, /* '>' */
+	0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20, 0x00, /* '?' */
+	0x70, 0x88, 0x08, 0x68, 0xA8, 0xA8, 0x70, 0x00, /* '@' */
+	0x70, 0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x00, /* 'A' */
+	0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0, 0x00, /* 'B' */
+	0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70, 0x00, /* 'C' */
+	0xE0, 0x90, 0x88, 0x88, 0x88, 0x90, 0xE0, 0x00, /* 'D' */
+	0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8, 0x00, /* 'E' */
+	0xF8, 0x80, 0x80, 0xE0, 0x80, 0x80, 0x80, 0x00, /* 'F' */
+	0x70, 0x88, 0x80, 0x80, 0x98, 0x88, 0x70, 0x00, /* 'G' */
+	0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88, 0x00, /* 'H' */
+	0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, /* 'I' */
+	0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60, 0x00, /* 'J' */
+	0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88, 0x00, /* 'K' */
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8, 0x00, /* 'L' */
+	0x88, 0xD8, 0xA8, 0x88, 0x88, 0x88, 0x88, 0x00, /* 'M' */
+	0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88, 0x00, /* 'N' */
+	0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70, 0x00, /* 'O' */
+	0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80, 0x00, /* 'P' */
+	0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68, 0x00, /* 'Q' */
+	0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88, 0x00, /* 'R' */
+	0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xF0, 0x00, /* 'S' */
+	0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, /* 'T' */
+	0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70, 0x00, /* 'U' */
+	0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00, /* 'V' */
+	0x88, 0x88, 0x88, 0xA8, 0xA8, 0xD8, 0x88, 0x00, /* 'W' */
+	0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88, 0x00, /* 'X' */
+	0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20, 0x00, /* 'Y' */
+	0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8, 0x00, /* 'Z' */
+	0x38, 0x20, 0x20, 0x20, 0x20, 0x20, 0x38, 0x00, /* '[' */
+	0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00, 0x00, /* 'backslash' */
+	0xE0, 0x20, 0x20, 0x20, 0x20, 0x20, 0xE0, 0x00, /* ']' */
+	0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, /* '^' */
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x00, /* '_' */
+	0x40, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, /* '`' */
+	0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78, 0x00, /* 'a' */
+	0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0xF0, 0x00, /* 'b' */
+	0x00, 0x00, 0x70, 0x80, 0x80, 0x88, 0x70, 0x00, /* 'c' */
+	0x08, 0x08, 0x68, 0x98, 0x88, 0x88, 0x78, 0x00, /* 'd' */
+	0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70, 0x00, /* 'e' */
+	0x30, 0x48, 0x40, 0xE0, 0x40, 0x40, 0x40, 0x00, /* 'f' */
+	0x00, 0x00, 0x78, 0x88, 0x78, 0x08, 0x30, 0x00, /* 'g' */
+	0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00, /* 'h' */
+	0x20, 0x00, 0x60, 0x20, 0x20, 0x20, 0x70, 0x00, /* 'i' */
+	0x10, 0x00, 0x30, 0x10, 0x10, 0x90, 0x60, 0x00, /* 'j' */
+	0x40, 0x40, 0x48, 0x50, 0x60, 0x50, 0x48, 0x00, /* 'k' */
+	0x60, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70, 0x00, /* 'l' */
+	0x00, 0x00, 0xD0, 0xA8, 0xA8, 0x88, 0x88, 0x00, /* 'm' */
+	0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88, 0x00, /* 'n' */
+	0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70, 0x00, /* 'o' */
+	0x00, 0x00, 0xF0, 0x88, 0xF0, 0x80, 0x80, 0x00, /* 'p' */
+	0x00, 0x00, 0x68, 0x98, 0x78, 0x08, 0x08, 0x00, /* 'q' */
+	0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80, 0x00, /* 'r' */
+	0x00, 0x00, 0x70, 0x80, 0x70, 0x08, 0xF0, 0x00, /* 's' */
+	0x40, 0x40, 0xE0, 0x40, 0x40, 0x48, 0x30, 0x00, /* 't' */
+	0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68, 0x00, /* 'u' */
+	0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20, 0x00, /* 'v' */
+	0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50, 0x00, /* 'w' */
+	0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88, 0x00, /* 'x' */
+	0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x70, 0x00, /* 'y' */
+	0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8, 0x00, /* 'z' */
+	0x10, 0x20, 0x20, 0x40, 0x20, 0x20, 0x10, 0x00, /* '{' */
+	0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, /* '|' */
+	0x40, 0x20, 0x20, 0x10, 0x20, 0x20, 0x40, 0x00, /* '}' */
+	0x00, 0x00, 0x40, 0xA8, 0x10, 0x00, 0x00, 0x00, /* '~' */
+};
+
+const lcdst_font_t lcdst_font6x8 = {6, 8, 0x20, 95, font6x8Bitmap};
+
+/*
+ * One glyph in the cache. It is the cell of one character encoded
+ * in one pixel size for one color pair. The entries are in the list
+ * from the most recently used and in the chain of their hash.
+ */
+typedef struct
+{
+	const lcdst_font_t *font;
+	unsigned int index;    /* The character; font->count = the empty cell */
+	uint8 color[6], pixel; /* The characters and the background; Pixel size */
+	uint8 *data;           /* The encoded cell */
+	unsigned int size;     /* The size of the memory of the data */
+	int prev, next, chain;
+} glyph_t;
+
+/* The glyph cache; Shared by all displays */
+static glyph_t glyphs[ST7735S_CFG_GLYPHS];
+static int buckets[GLYPH_BUCKETS];
+static int glyphFirst = NONE, glyphLast = NONE, glyphCount;
+static uint8 glyphReady;
+static pthread_mutex_t glyphLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Safe allocation of the memory block.
+ *
+ * Parameters:
+ *   size - Size of memory block to allocate.
+ *
+ * Return:
+ *   Pointer to the memory block. If an error occurs, stop the program.
+ */
+static void *safeMalloc(size_t size)
+{
+	void *memoryBlock = malloc(size);
+	
+	/* Check the pointer */
+	if(memoryBlock == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return memoryBlock;
+} /* safeMalloc */
+
+/*
+ * Compute the hash of the key of the glyph.
+ */
+static unsigned int glyphHash(const lcdst_font_t *font, unsigned int index,
+							  const uint8 *color, uint8 pixel)
+{
+	uint32_t hash = 2166136261u;
+	unsigned int i;
+	
+	/* FNV-1a of the key */
+	hash = (hash ^ (uint32_t) (uintptr_t) font) * 16777619u;
+	hash = (hash ^ index) * 16777619u;
+	for(i = 0; i < 6; i++) hash = (hash ^ color[i]) * 16777619u;
+	hash = (hash ^ pixel) * 16777619u;
+	
+	return hash % GLYPH_BUCKETS;
+} /* glyphHash */
+
+/*
+ * Remove the entry from the list of the recently used glyphs.
+ */
+static void glyphUnlink(int i)
+{
+	if(glyphs[i].prev != NONE) glyphs[glyphs[i].prev].next = glyphs[i].next;
+	else glyphFirst = glyphs[i].next;
+	if(glyphs[i].next != NONE) glyphs[glyphs[i].next].prev = glyphs[i].prev;
+	else glyphLast = glyphs[i].prev;
+} /* glyphUnlink */
+
+/*
+ * Insert the entry at the start of the list of the recently used glyphs.
+ */
+static void glyphLinkFirst(int i)
+{
+	glyphs[i].prev = NONE;
+	glyphs[i].next = glyphFirst;
+	if(glyphFirst != NONE) glyphs[glyphFirst].prev = i;
+	else glyphLast = i;
+	glyphFirst = i;
+} /* glyphLinkFirst */
+
+/*
+ * Insert the entry at the end of the list of the recently used glyphs,
+ * so it is taken first for the next glyph.
+ */
+static void glyphLinkLast(int i)
+{
+	glyphs[i].next = NONE;
+	glyphs[i].prev = glyphLast;
+	if(glyphLast != NONE) glyphs[glyphLast].next = i;
+	else glyphFirst = i;
+	glyphLast = i;
+} /* glyphLinkLast */
+
+/*
+ * Remove the entry from the chain of its hash.
+ * The dropped entry (without the font) is not in any chain.
+ */
+static void glyphUnchain(int i)
+{
+	glyph_t *glyph = glyphs + i;
+	int *link;
+	
+	if(glyph->font == NULL) return;
+	link = buckets + glyphHash(glyph->font, glyph->index,
+							   glyph->color, glyph->pixel);
+	while(*link != i) link = &glyphs[*link].chain;
+	*link = glyph->chain;
+} /* glyphUnchain */
+
+/*
+ * Encode the cell of the character in the pixel size.
+ * In the reduced format the pixels are paired across the rows.
+ *
+ * Parameters:
+ *   glyph - The entry with the key; The data receives the encoded cell.
+ */
+static void glyphEncode(glyph_t *glyph)
+{
+	const lcdst_font_t *font = glyph->font;
+	unsigned int pitch = (font->width + 7) / 8, n = font->width * font->height;
+	unsigned int size, x, y, i = 0;
+	const uint8 *cell = NULL, *c;
+	uint8 *out, half = 0;
+	
+	switch(glyph->pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  size = n * 2; break;
+		case ST7735S_PIXEL_REDUCED: size = (n * 3 + 1) / 2; break;
+		default:                    size = n * 3; break;
+	}
+	
+	/* Keep the memory of the dropped glyph, if it is large enough */
+	if(glyph->size < size)
+	{
+		free(glyph->data);
+		glyph->data = (uint8 *) safeMalloc(size);
+		glyph->size = size;
+	}
+	out = glyph->data;
+	
+	if(glyph->index < font->count)
+		cell = font->bitmap + glyph->index * pitch * font->height;
+	
+	for(y = 0; y < font->height; y++)
+		for(x = 0; x < font->width; x++, i++)
+		{
+			c = glyph->color + 3;
+			if((cell != NULL) && (cell[y * pitch + x / 8] & (0x80 >> (x % 8))))
+				c = glyph->color;
+			
+			switch(glyph->pixel)
+			{
+				case ST7735S_PIXEL_MEDIUM:
+					*out++ = (c[0] & 0xF8) | (c[1] >> 5);
+					*out++ = ((c[1] << 3) & 0xE0) | (c[2] >> 3);
+					break;
+				
+				case ST7735S_PIXEL_REDUCED:
+					if(i & 1)
+					{
+						*out++ = half | (c[0] >> 4);
+						*out++ = (c[1] & 0xF0) | (c[2] >> 4);
+					}
+					else
+					{
+						*out++ = (c[0] & 0xF0) | (c[1] >> 4);
+						half = c[2] & 0xF0;
+					}
+					break;
+				
+				default:
+					*out++ = c[0]; *out++ = c[1]; *out++ = c[2];
+					break;
+			}
+		}
+	
+	/* The half of the last odd pixel */
+	if((glyph->pixel == ST7735S_PIXEL_REDUCED) && (i & 1)) *out = half;
+} /* glyphEncode */
+
+/*
+ * Find the encoded glyph in the cache or encode it. The found glyph
+ * becomes the most recently used one. The cache must be locked.
+ *
+ * Return: Pointer to the encoded cell.
+ */
+static const uint8 *glyphGet(const lcdst_font_t *font, unsigned int index,
+							 const uint8 *color, uint8 pixel)
+{
+	unsigned int hash = glyphHash(font, index, color, pixel);
+	glyph_t *glyph;
+	int i;
+	
+	if(!glyphReady)
+	{
+		for(i = 0; i < GLYPH_BUCKETS; i++) buckets[i] = NONE;
+		glyphReady = 1;
+	}
+	
+	/* The glyph is in the cache */
+	for(i = buckets[hash]; i != NONE; i = glyphs[i].chain)
+	{
+		glyph = glyphs + i;
+		if((glyph->font == font) && (glyph->index == index)
+		&& (glyph->pixel == pixel) && !memcmp(glyph->color, color, 6))
+		{
+			glyphUnlink(i);
+			glyphLinkFirst(i);
+			return glyph->data;
+		}
+	}
+	
+	/* Take the free entry or drop the least recently used glyph */
+	if(glyphCount < ST7735S_CFG_GLYPHS) i = glyphCount++;
+	else
+	{
+		i = glyphLast;
+		glyphUnlink(i);
+		glyphUnchain(i);
+	}
+	
+	glyph = glyphs + i;
+	glyph->font = font;
+	glyph->index = index;
+	glyph->pixel = pixel;
+	memcpy(glyph->color, color, 6);
+	
+	glyphEncode(glyph);
+	glyph->chain = buckets[hash];
+	buckets[hash] = i;
+	glyphLinkFirst(i);
+	
+	return glyph->data;
+} /* glyphGet */
+
+/*
+ * Find the index of the cell of the character in the font.
+ *
+ * Return: The index; font->count if the font does not have the character.
+ */
+static unsigned int charIndex(const lcdst_font_t *font, char character)
+{
+	unsigned int code = (unsigned char) character;
+	
+	if((code < font->first) || (code - font->first >= font->count))
+		return font->count;
+	return code - font->first;
+} /* charIndex */
+
+/*
+ * Draw the whole characters into the framebuffer of the display.
+ * The glyphs are cached in the full pixel size, which is the layout
+ * of the framebuffer.
+ */
+static void fbText(lcdst_t *display, uint8 x, uint8 y, const char *text,
+				   unsigned int n, const lcdst_font_t *font, const uint8 *color)
+{
+	unsigned int stride = display->width * 3, size = font->width * 3;
+	const uint8 *cell;
+	uint8 *fb;
+	unsigned int i, row;
+	
+	pthread_mutex_lock(&glyphLock);
+	for(i = 0; i < n; i++)
+	{
+		cell = glyphGet(font, charIndex(font, text[i]), color, ST7735S_PIXEL_FULL);
+		fb = display->framebuffer + (size_t) y * stride + (x + i * font->width) * 3;
+		for(row = 0; row < font->height; row++, fb += stride, cell += size)
+			memcpy(fb, cell, size);
+	}
+	pthread_mutex_unlock(&glyphLock);
+	
+	lcdst_markDirtyOn(display, x, y, n * font->width, font->height);
+} /* fbText */
+
+uint8 lcdst_drawTextOn(lcdst_t *display, uint8 x, uint8 y, const char *text,
+					   const lcdst_font_t *font, uint8 r, uint8 g, uint8 b,
+					   uint8 br, uint8 bg, uint8 bb)
+{
+	uint8 color[6] = {r, g, b, br, bg, bb};
+	unsigned int n, count, i, row, rowSize, cellSize, w, h;
+	uint8 pixel = display->pixel, lines, *cells, result = 0;
+	
+	if((text == NULL) || (font == NULL)) return 1;
+	w = font->width; h = font->height;
+	if((w == 0) || (h == 0)) return 1;
+	
+	/* Draw only the whole characters in the display space */
+	if((x >= display->width) || (y + h > display->height)) return 1;
+	n = (display->width - x) / w;
+	for(count = 0; (count < n) && text[count]; count++);
+	n = count;
+	
+	if(display->framebuffer != NULL)
+	{
+		fbText(display, x, y, text, n, font, color);
+		return 0;
+	}
+	
+	/* The encoded size of one row of the cell and of the whole cell */
+	switch(pixel)
+	{
+		case ST7735S_PIXEL_MEDIUM:  rowSize = w * 2; cellSize = rowSize * h; break;
+		case ST7735S_PIXEL_REDUCED: rowSize = w * 3 / 2; cellSize = (w * h * 3 + 1) / 2; break;
+		default:                    rowSize = w * 3; cellSize = rowSize * h; break;
+	}
+	
+	/* The rows of the reduced cells can be joined only with whole pairs */
+	lines = (pixel != ST7735S_PIXEL_REDUCED) || !(w & 1);
+	
+	/*
+	 * The cache is shared by the displays, so the cells of one part
+	 * are copied out under its lock and sent without it.
+	 */
+	count = (n < ST7735S_CFG_GLYPHS) ? n : ST7735S_CFG_GLYPHS;
+	cells = (uint8 *) safeMalloc((size_t) count * cellSize);
+	
+	for(; n && !result; n -= count, text += count, x += count * w)
+	{
+		count = (n < ST7735S_CFG_GLYPHS) ? n : ST7735S_CFG_GLYPHS;
+		pthread_mutex_lock(&glyphLock);
+		for(i = 0; i < count; i++)
+			memcpy(cells + i * cellSize, glyphGet(font, charIndex(font, text[i]),
+				   color, pixel), cellSize);
+		pthread_mutex_unlock(&glyphLock);
+		
+		if(lines)
+		{
+			/* One window; The rows of the cells one after another */
+			result = lcdst_setWindowOn(display, x, y,
+									   x + count * w - 1, y + h - 1);
+			if(result) break;
+			for(row = 0; row < h; row++)
+				for(i = 0; i < count; i++)
+					lcdst_pushEncodedOn(display, cells + i * cellSize
+										+ row * rowSize, rowSize);
+		}
+		else for(i = 0; i < count; i++)
+		{
+			/* One window per cell */
+			result = lcdst_setWindowOn(display, x + i * w, y,
+									   x + i * w + w - 1, y + h - 1);
+			if(result) break;
+			lcdst_pushEncodedOn(display, cells + i * cellSize, cellSize);
+		}
+	}
+	
+	free(cells);
+	if(result) return result;
+	return lcdst_sendBufferOn(display);
+} /* lcdst_drawTextOn */
+
+/*
+ * Convert the hexadecimal digit to its value.
+ *
+ * Return: The value; 0 for the other characters.
+ */
+static uint8 hexDigit(char digit)
+{
+	if((digit >= '0') && (digit <= '9')) return digit - '0';
+	if((digit >= 'A') && (digit <= 'F')) return digit - 'A' + 10;
+	if((digit >= 'a') && (digit <= 'f')) return digit - 'a' + 10;
+	return 0;
+} /* hexDigit */
+
+lcdst_font_t *lcdst_loadFont(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	lcdst_font_t *font = NULL;
+	uint8 *bitmap = NULL;
+	char line[256];
+	int fw, fh, fx, fy, bw = 0, bh = 0, bx = 0, by = 0;
+	int code = -1, row = -1, low = 256, high = -1, cx, cy, i;
+	unsigned int pitch = 0, cellSize = 0;
+	
+	if(file == NULL) return NULL;
+	
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		if(sscanf(line, "FONTBOUNDINGBOX %d %d %d %d", &fw, &fh, &fx, &fy) == 4)
+		{
+			/* The cell of every character; 256 cells until the end */
+			if((font != NULL) || (fw < 1) || (fw > 255) || (fh < 1) || (fh > 255))
+				break;
+			pitch = (fw + 7) / 8;
+			cellSize = pitch * fh;
+			font = (lcdst_font_t *) calloc(1, sizeof(lcdst_font_t) + 256 * cellSize);
+			if(font == NULL) break;
+			bitmap = (uint8 *) (font + 1);
+			font->width = fw;
+			font->height = fh;
+		}
+		else if(sscanf(line, "ENCODING %d", &code) == 1) continue;
+		else if(sscanf(line, "BBX %d %d %d %d", &bw, &bh, &bx, &by) == 4) continue;
+		else if(!strncmp(line, "BITMAP", 6))
+		{
+			/* Only the characters from 0 to 255 in the known cell */
+			if((font == NULL) || (code < 0) || (code > 255)) continue;
+			if(code < low) low = code;
+			if(code > high) high = code;
+			row = 0;
+		}
+		else if(!strncmp(line, "ENDCHAR", 7)) {row = -1; code = -1;}
+		else if(row >= 0)
+		{
+			/* Place the row of the character at its baseline in the cell */
+			cy = (fh + fy) - (by + bh) + row++;
+			if((cy < 0) || (cy >= fh)) continue;
+			for(i = 0; (i < bw) && line[i / 4] && (line[i / 4] != '\n'); i++)
+			{
+				cx = bx - fx + i;
+				if((cx < 0) || (cx >= fw)) continue;
+				if(hexDigit(line[i / 4]) & (8 >> (i % 4)))
+					bitmap[code * cellSize + cy * pitch + cx / 8] |= 0x80 >> (cx % 8);
+			}
+		}
+	}
+	
+	fclose(file);
+	
+	/* The font without any character is an error */
+	if((font != NULL) && (high < 0)) {free(font); font = NULL;}
+	if(font == NULL) return NULL;
+	
+	/* Keep only the cells from the first to the last character */
+	memmove(bitmap, bitmap + low * cellSize, (high - low + 1) * cellSize);
+	font->first = low;
+	font->count = high - low + 1;
+	font->bitmap = bitmap;
+	
+	return font;
+} /* lcdst_loadFont */
+
+void lcdst_freeFont(lcdst_font_t *font)
+{
+	int i;
+	
+	if(font == NULL) return;
+	
+	/* Drop the glyphs of the font; Their entries are taken first */
+	pthread_mutex_lock(&glyphLock);
+	for(i = 0; i < glyphCount; i++)
+	{
+		if(glyphs[i].font != font) continue;
+		glyphUnchain(i);
+		glyphs[i].font = NULL;
+		glyphUnlink(i);
+		glyphLinkLast(i);
+	}
+	pthread_mutex_unlock(&glyphLock);
+	
+	free(font);
+} /* lcdst_freeFont */
+
+void lcdst_clearGlyphCache(void)
+{
+	int i;
+	
+	pthread_mutex_lock(&glyphLock);
+	for(i = 0; i < glyphCount; i++)
+	{
+		free(glyphs[i].data);
+		glyphs[i].data = NULL;
+		glyphs[i].size = 0;
+	}
+	
+	glyphCount = 0;
+	glyphFirst = glyphLast = NONE;
+	glyphReady = 0;
+	pthread_mutex_unlock(&glyphLock);
+} /* lcdst_clearGlyphCache */
+
+/*
+ * The functions of the currently active display.
+ */
+
+uint8 lcdst_drawText(uint8 x, uint8 y, const char *text,
+					 const lcdst_font_t *font, uint8 r, uint8 g, uint8 b,
+					 uint8 br, uint8 bg, uint8 bb)
+{
+	return lcdst_drawTextOn(lcdst_getActiveDisplay(), x, y, text, font,
+							r, g, b, br, bg, bb);
+} /* lcdst_drawText */
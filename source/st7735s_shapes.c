@@ -0,0 +1,494 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "st7735s.h"
+
+/*
+ * The run of the pixels collected from the rasterizer. The neighbouring
+ * pixels in one row or in one column are drawn as one line, so they cost
+ * one window instead of one window per pixel.
+ */
+typedef struct
+{
+	lcdst_t *display;
+	int x1, y1, x2, y2;
+	uint8 r, g, b, active;
+} run_t;
+
+/*
+ * Draw the horizontal span clipped to the display space.
+ */
+static void drawSpan(lcdst_t *display, int x1, int x2, int y,
+					 uint8 r, uint8 g, uint8 b)
+{
+	int width = display->width;
+	
+	if((y < 0) || (y >= display->height)) return;
+	if(x1 < 0) x1 = 0;
+	if(x2 >= width) x2 = width - 1;
+	if(x1 > x2) return;
+	
+	lcdst_drawHLineOn(display, x1, y, x2 - x1 + 1, r, g, b);
+} /* drawSpan */
+
+/*
+ * Draw the vertical span clipped to the display space.
+ */
+static void drawColumn(lcdst_t *display, int x, int y1, int y2,
+					   uint8 r, uint8 g, uint8 b)
+{
+	int height = display->height;
+	
+	if((x < 0) || (x >= display->width)) return;
+	if(y1 < 0) y1 = 0;
+	if(y2 >= height) y2 = height - 1;
+	if(y1 > y2) return;
+	
+	lcdst_drawVLineOn(display, x, y1, y2 - y1 + 1, r, g, b);
+} /* drawColumn */
+
+/*
+ * Draw the collected run and start the new one.
+ */
+static void runFlush(run_t *run)
+{
+	if(!run->active) return;
+	run->active = 0;
+	
+	if(run->y1 == run->y2)
+		drawSpan(run->display, run->x1, run->x2, run->y1,
+				 run->r, run->g, run->b);
+	else
+		drawColumn(run->display, run->x1, run->y1, run->y2,
+				   run->r, run->g, run->b);
+} /* runFlush */
+
+/*
+ * Add the pixel to the run. The pixel extends the run, when it is
+ * the neighbour of its end in the same row or in the same column.
+ */
+static void runAdd(run_t *run, int x, int y)
+{
+	if(run->active)
+	{
+		/* The horizontal run or the single pixel */
+		if(run->y1 == y && run->y2 == y)
+		{
+			if(x == run->x2 + 1) {run->x2 = x; return;}
+			if(x == run->x1 - 1) {run->x1 = x; return;}
+		}
+	
+		/* The vertical run or the single pixel */
+		if(run->x1 == x && run->x2 == x)
+		{
+			if(y == run->y2 + 1) {run->y2 = y; return;}
+			if(y == run->y1 - 1) {run->y1 = y; return;}
+		}
+	
+		/* The same pixel again */
+		if((x >= run->x1) && (x <= run->x2) && (y >= run->y1) && (y <= run->y2))
+			return;
+	
+		runFlush(run);
+	}
+	
+	run->x1 = run->x2 = x;
+	run->y1 = run->y2 = y;
+	run->active = 1;
+} /* runAdd */
+
+void lcdst_drawLineOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+					  uint8 r, uint8 g, uint8 b)
+{
+	run_t run = {display, 0, 0, 0, 0, r, g, b, 0};
+	int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+	int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+	int error = dx + dy, e2;
+	
+	/* Bresenham's algorithm; The steps in one axis form the runs */
+	for(;;)
+	{
+		runAdd(&run, x1, y1);
+		if((x1 == x2) && (y1 == y2)) break;
+	
+		e2 = 2 * error;
+		if(e2 >= dy) {error += dy; x1 += sx;}
+		if(e2 <= dx) {error += dx; y1 += sy;}
+	}
+	
+	runFlush(&run);
+} /* lcdst_drawLineOn */
+
+/*
+ * Walk the circle by the midpoint algorithm. The pixels are visited octant
+ * by octant in the order around the circle, so the neighbours form runs.
+ * Only the pixels with the angle in the range are drawn.
+ *
+ * Parameters:
+ *   from, to - The angle range in degrees; 0 = right, 90 = up.
+ *   full - 1 = Ignore the angles.
+ */
+static void walkCircle(lcdst_t *display, int cx, int cy, int radius,
+					   double from, double to, uint8 full,
+					   uint8 r, uint8 g, uint8 b)
+{
+	run_t run = {display, 0, 0, 0, 0, r, g, b, 0};
+	int *xs, *ys, count = 0, octant, i, j, x, y, error;
+	double angle;
+	
+	if(radius < 0) return;
+	if(radius == 0) {drawSpan(display, cx, cx, cy, r, g, b); return;}
+	
+	/* The points of the first octant; From the right, going up */
+	xs = (int *) malloc(sizeof(int) * 2 * (radius + 2));
+	if(xs == NULL) return;
+	ys = xs + radius + 2;
+	
+	for(x = radius, y = 0, error = 1 - radius; y <= x; y++)
+	{
+		xs[count] = x; ys[count] = y; count++;
+		if(error < 0) error += 2 * y + 3;
+		else {x--; error += 2 * (y - x) + 3;}
+	}
+	
+	/* Map the first octant to all of them; Odd octants go backwards */
+	for(octant = 0; octant < 8; octant++)
+		for(j = 0; j < count; j++)
+		{
+			i = (octant & 1) ? count - 1 - j : j;
+			switch(octant)
+			{
+				case 0:  x =  xs[i]; y =  ys[i]; break;
+				case 1:  x =  ys[i]; y =  xs[i]; break;
+				case 2:  x = -ys[i]; y =  xs[i]; break;
+				case 3:  x = -xs[i]; y =  ys[i]; break;
+				case 4:  x = -xs[i]; y = -ys[i]; break;
+				case 5:  x = -ys[i]; y = -xs[i]; break;
+				case 6:  x =  ys[i]; y = -xs[i]; break;
+				default: x =  xs[i]; y = -ys[i]; break;
+			}
+	
+			if(!full)
+			{
+				angle = atan2(y, x) * (180.0 / M_PI);
+				if(angle < 0) angle += 360.0;
+				if(from <= to ? (angle < from || angle > to)
+							  : (angle < from && angle > to))
+				{
+					runFlush(&run);
+					continue;
+				}
+			}
+	
+			/* The Y axis of the display goes down */
+			runAdd(&run, cx + x, cy - y);
+		}
+	
+	runFlush(&run);
+	free(xs);
+} /* walkCircle */
+
+void lcdst_drawCircleOn(lcdst_t *display, int cx, int cy, int radius,
+						uint8 r, uint8 g, uint8 b)
+{
+	walkCircle(display, cx, cy, radius, 0, 0, 1, r, g, b);
+} /* lcdst_drawCircleOn */
+
+void lcdst_drawArcOn(lcdst_t *display, int cx, int cy, int radius,
+					 int from, int to, uint8 r, uint8 g, uint8 b)
+{
+	uint8 full;
+	
+	/* The sweep by whole turns is the whole circle, like 0 to 360 */
+	full = (to != from) && ((to - from) % 360 == 0);
+	
+	/* Normalize the angles to the range from 0 to 359 */
+	from %= 360; if(from < 0) from += 360;
+	to   %= 360; if(to   < 0) to   += 360;
+	
+	walkCircle(display, cx, cy, radius, from, to, full, r, g, b);
+} /* lcdst_drawArcOn */
+
+void lcdst_fillCircleOn(lcdst_t *display, int cx, int cy, int radius,
+						uint8 r, uint8 g, uint8 b)
+{
+	int y, half;
+	
+	if(radius < 0) return;
+	
+	/* One span per row; The half width is rounded like the midpoint circle */
+	for(y = -radius; y <= radius; y++)
+	{
+		half = (int) sqrt((double) radius * radius - (double) y * y + radius);
+		if(half > radius) half = radius;
+		drawSpan(display, cx - half, cx + half, cy + y, r, g, b);
+	}
+} /* lcdst_fillCircleOn */
+
+void lcdst_drawTriangleOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						  int x3, int y3, uint8 r, uint8 g, uint8 b)
+{
+	lcdst_drawLineOn(display, x1, y1, x2, y2, r, g, b);
+	lcdst_drawLineOn(display, x2, y2, x3, y3, r, g, b);
+	lcdst_drawLineOn(display, x3, y3, x1, y1, r, g, b);
+} /* lcdst_drawTriangleOn */
+
+void lcdst_fillTriangleOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						  int x3, int y3, uint8 r, uint8 g, uint8 b)
+{
+	int points[6] = {x1, y1, x2, y2, x3, y3};
+	
+	lcdst_fillPolygonOn(display, points, 3, r, g, b);
+} /* lcdst_fillTriangleOn */
+
+uint8 lcdst_fillPolygonOn(lcdst_t *display, const int *points,
+						  unsigned int count, uint8 r, uint8 g, uint8 b)
+{
+	int *nodes, top, bottom, y, i, j, swap, xa, ya, xb, yb;
+	unsigned int k, found;
+	
+	if((points == NULL) || (count < 3)) return 1;
+	
+	nodes = (int *) malloc(sizeof(int) * count);
+	if(nodes == NULL) return 1;
+	
+	/* The rows of the polygon inside the display space */
+	top = bottom = points[1];
+	for(k = 1; k < count; k++)
+	{
+		if(points[2*k+1] < top)    top    = points[2*k+1];
+		if(points[2*k+1] > bottom) bottom = points[2*k+1];
+	}
+	if(top < 0) top = 0;
+	if(bottom >= display->height) bottom = display->height - 1;
+	
+	for(y = top; y <= bottom; y++)
+	{
+		/* The crossings of the edges with the center of the row */
+		for(k = 0, found = 0; k < count; k++)
+		{
+			xa = points[2*k];   ya = points[2*k+1];
+			xb = points[2*((k+1) % count)];
+			yb = points[2*((k+1) % count)+1];
+	
+			if((ya <= y && yb > y) || (yb <= y && ya > y))
+				nodes[found++] = xa + (int) lround((double) (y - ya)
+					* (xb - xa) / (double) (yb - ya));
+		}
+	
+		/* Sort the crossings; There are only a few of them */
+		for(i = 1; i < (int) found; i++)
+		{
+			for(j = i, swap = nodes[i]; j > 0 && nodes[j-1] > swap; j--)
+				nodes[j] = nodes[j-1];
+			nodes[j] = swap;
+		}
+	
+		/* Fill between the pairs; The even-odd rule */
+		for(k = 0; k + 1 < found; k += 2)
+			drawSpan(display, nodes[k], nodes[k+1], y, r, g, b);
+	}
+	
+	/*
+	 * The rows cross the edges only at their centers; The flat edges and
+	 * the bottom vertices are not crossed at all. Draw the outline too,
+	 * so the fill covers the lines of lcdst_drawTriangle().
+	 */
+	for(k = 0; k < count; k++)
+		lcdst_drawLineOn(display, points[2*k], points[2*k+1],
+						 points[2*((k+1) % count)],
+						 points[2*((k+1) % count)+1], r, g, b);
+	
+	free(nodes);
+	return 0;
+} /* lcdst_fillPolygonOn */
+
+/*
+ * Blend the color into the pixel of the framebuffer.
+ *
+ * Parameters:
+ *   coverage - The part of the pixel covered by the shape; 0 to 255.
+ */
+static void blendPx(lcdst_t *display, int x, int y, unsigned int coverage,
+					uint8 r, uint8 g, uint8 b)
+{
+	uint8 *px;
+	
+	if((x < 0) || (y < 0) || (x >= display->width) || (y >= display->height))
+		return;
+	if(coverage > 255) coverage = 255;
+	
+	px = display->framebuffer + ((size_t) y * display->width + x) * 3;
+	px[0] += ((int) r - px[0]) * (int) coverage / 255;
+	px[1] += ((int) g - px[1]) * (int) coverage / 255;
+	px[2] += ((int) b - px[2]) * (int) coverage / 255;
+} /* blendPx */
+
+/*
+ * Mark the bounding box of the shape as changed.
+ */
+static void markBox(lcdst_t *display, int x1, int y1, int x2, int y2)
+{
+	if(x1 < 0) x1 = 0;
+	if(y1 < 0) y1 = 0;
+	if(x2 >= display->width)  x2 = display->width - 1;
+	if(y2 >= display->height) y2 = display->height - 1;
+	if((x1 > x2) || (y1 > y2)) return;
+	
+	lcdst_markDirtyOn(display, x1, y1, x2 - x1 + 1, y2 - y1 + 1);
+} /* markBox */
+
+uint8 lcdst_drawLineAAOn(lcdst_t *display, int x1, int y1, int x2, int y2,
+						 uint8 r, uint8 g, uint8 b)
+{
+	int steep = abs(y2 - y1) > abs(x2 - x1), t, x;
+	double gradient, intery, fraction;
+	unsigned int coverage;
+	
+	if(display->framebuffer == NULL) return 1;
+	markBox(display, x1 < x2 ? x1 : x2, (y1 < y2 ? y1 : y2) - 1,
+			x1 > x2 ? x1 : x2, (y1 > y2 ? y1 : y2) + 1);
+	markBox(display, (x1 < x2 ? x1 : x2) - 1, y1 < y2 ? y1 : y2,
+			(x1 > x2 ? x1 : x2) + 1, y1 > y2 ? y1 : y2);
+	
+	/* Xiaolin Wu's algorithm; Walk along the longer axis */
+	if(steep) {t = x1; x1 = y1; y1 = t; t = x2; x2 = y2; y2 = t;}
+	if(x1 > x2) {t = x1; x1 = x2; x2 = t; t = y1; y1 = y2; y2 = t;}
+	
+	gradient = (x2 == x1) ? 1.0 : (double) (y2 - y1) / (x2 - x1);
+	intery = y1;
+	
+	for(x = x1; x <= x2; x++, intery += gradient)
+	{
+		fraction = intery - floor(intery);
+		coverage = (unsigned int) lround((1.0 - fraction) * 255);
+	
+		if(steep)
+		{
+			blendPx(display, (int) floor(intery),     x, coverage, r, g, b);
+			blendPx(display, (int) floor(intery) + 1, x, 255 - coverage, r, g, b);
+		}
+		else
+		{
+			blendPx(display, x, (int) floor(intery),     coverage, r, g, b);
+			blendPx(display, x, (int) floor(intery) + 1, 255 - coverage, r, g, b);
+		}
+	}
+	
+	return 0;
+} /* lcdst_drawLineAAOn */
+
+uint8 lcdst_drawCircleAAOn(lcdst_t *display, int cx, int cy, int radius,
+						   uint8 r, uint8 g, uint8 b)
+{
+	double exact, fraction;
+	unsigned int coverage;
+	int i, inner;
+	
+	if(display->framebuffer == NULL) return 1;
+	if(radius <= 0) return 0;
+	markBox(display, cx - radius - 1, cy - radius - 1,
+			cx + radius + 1, cy + radius + 1);
+	
+	/*
+	 * Walk one octant. The exact distance of the circle from the axis
+	 * splits the color between the two pixels across the circle.
+	 */
+	for(i = 0; i <= (int) ceil(radius / M_SQRT2); i++)
+	{
+		exact = sqrt((double) radius * radius - (double) i * i);
+		inner = (int) floor(exact);
+		fraction = exact - inner;
+		coverage = (unsigned int) lround(fraction * 255);
+	
+		/* The outer pixel gets the fraction, the inner one the rest */
+		blendPx(display, cx + inner + 1, cy + i, coverage, r, g, b);
+		blendPx(display, cx + inner,     cy + i, 255 - coverage, r, g, b);
+		blendPx(display, cx - inner - 1, cy + i, coverage, r, g, b);
+		blendPx(display, cx - inner,     cy + i, 255 - coverage, r, g, b);
+		blendPx(display, cx + inner + 1, cy - i, coverage, r, g, b);
+		blendPx(display, cx + inner,     cy - i, 255 - coverage, r, g, b);
+		blendPx(display, cx - inner - 1, cy - i, coverage, r, g, b);
+		blendPx(display, cx - inner,     cy - i, 255 - coverage, r, g, b);
+	
+		blendPx(display, cx + i, cy + inner + 1, coverage, r, g, b);
+		blendPx(display, cx + i, cy + inner,     255 - coverage, r, g, b);
+		blendPx(display, cx - i, cy + inner + 1, coverage, r, g, b);
+		blendPx(display, cx - i, cy + inner,     255 - coverage, r, g, b);
+		blendPx(display, cx + i, cy - inner - 1, coverage, r, g, b);
+		blendPx(display, cx + i, cy - inner,     255 - coverage, r, g, b);
+		blendPx(display, cx - i, cy - inner - 1, coverage, r, g, b);
+		blendPx(display, cx - i, cy - inner,     255 - coverage, r, g, b);
+	}
+	
+	return 0;
+} /* lcdst_drawCircleAAOn */
+
+/*
+ * The functions of the currently active display.
+ */
+
+void lcdst_drawLine(int x1, int y1, int x2, int y2,
+					uint8 r, uint8 g, uint8 b)
+{
+	lcdst_drawLineOn(lcdst_getActiveDisplay(), x1, y1, x2, y2, r, g, b);
+} /* lcdst_drawLine */
+
+void lcdst_drawCircle(int cx, int cy, int radius, uint8 r, uint8 g, uint8 b)
+{
+	lcdst_drawCircleOn(lcdst_getActiveDisplay(), cx, cy, radius, r, g, b);
+} /* lcdst_drawCircle */
+
+void lcdst_drawArc(int cx, int cy, int radius, int from, int to,
+				   uint8 r, uint8 g, uint8 b)
+{
+	lcdst_drawArcOn(lcdst_getActiveDisplay(), cx, cy, radius, from, to,
+					r, g, b);
+} /* lcdst_drawArc */
+
+void lcdst_fillCircle(int cx, int cy, int radius, uint8 r, uint8 g, uint8 b)
+{
+	lcdst_fillCircleOn(lcdst_getActiveDisplay(), cx, cy, radius, r, g, b);
+} /* lcdst_fillCircle */
+
+void lcdst_drawTriangle(int x1, int y1, int x2, int y2, int x3, int y3,
+						uint8 r, uint8 g, uint8 b)
+{
+	lcdst_drawTriangleOn(lcdst_getActiveDisplay(), x1, y1, x2, y2, x3, y3,
+						 r, g, b);
+} /* lcdst_drawTriangle */
+
+void lcdst_fillTriangle(int x1, int y1, int x2, int y2, int x3, int y3,
+						uint8 r, uint8 g, uint8 b)
+{
+	lcdst_fillTriangleOn(lcdst_getActiveDisplay(), x1, y1, x2, y2, x3, y3,
+						 r, g, b);
+} /* lcdst_fillTriangle */
+
+uint8 lcdst_fillPolygon(const int *points, unsigned int count,
+						uint8 r, uint8 g, uint8 b)
+{
+	return lcdst_fillPolygonOn(lcdst_getActiveDisplay(), points, count,
+							   r, g, b);
+} /* lcdst_fillPolygon */
+
+uint8 lcdst_drawLineAA(int x1, int y1, int x2, int y2,
+					   uint8 r, uint8 g, uint8 b)
+{
+	return lcdst_drawLineAAOn(lcdst_getActiveDisplay(), x1, y1, x2, y2,
+							  r, g, b);
+} /* lcdst_drawLineAA */
+
+uint8 lcdst_drawCircleAA(int cx, int cy, int radius,
+						 uint8 r, uint8 g, uint8 b)
+{
+	return lcdst_drawCircleAAOn(lcdst_getActiveDisplay(), cx, cy, radius,
+								r, g, b);
+} /* lcdst_drawCircleAA */
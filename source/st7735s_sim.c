@@ -0,0 +1,491 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "st7735s_sim.h"
+
+/* The size of the frame memory and of the visible panel */
+#define GRAM_COLUMNS 132
+#define GRAM_ROWS 162
+#define PANEL_COLUMNS 128
+#define PANEL_ROWS 160
+
+/* The bits of the Memory Data Access Control */
+#define MADCTL_MY 0x80
+#define MADCTL_MX 0x40
+#define MADCTL_MV 0x20
+#define MADCTL_BGR 0x08
+
+/*
+ * The modeled costs in seconds: one SPI message (the kernel round trip
+ * of the spidev ioctl) and one change of the D/C line (the sysfs write).
+ */
+#define TRANSACTION_TIME 10e-6
+#define DC_TIME 5e-6
+
+/* The minimum waits of the datasheet in seconds */
+#define RESET_WAIT 120e-3  /* After the reset, before the Sleep Out */
+#define COMMAND_WAIT 5e-3  /* After the reset or the Sleep Out */
+
+/* The state of the simulated panel */
+typedef struct
+{
+	/* The frame memory; 6-bit components: r, g, b */
+	uint8 gram[GRAM_ROWS][GRAM_COLUMNS][3];
+	
+	/* The command decoder */
+	uint8 dc, reset, resetAwake, command;
+	uint8 params[6];
+	unsigned int paramCount;
+	
+	/* The registers */
+	uint8 madctl, colmod;
+	uint8 sleeping, on, inverted, idle, scrolling;
+	unsigned int xs, xe, ys, ye;
+	unsigned int tfa, vsa, bfa, ssa;
+	
+	/* The address counter and the bits of the incomplete pixel */
+	unsigned int x, y;
+	unsigned long bits;
+	unsigned int bitCount;
+	
+	/* The modeled time; The earliest times of the next commands */
+	double speed, clock;
+	double readyAt, wakeAt;
+	
+	lcdst_simstats_t stats;
+} simContext;
+
+/*
+ * Set the registers to their values after the reset.
+ * The content of the frame memory is not changed.
+ */
+static void resetState(simContext *sim)
+{
+	sim->command = 0;
+	sim->paramCount = 0;
+	sim->bitCount = 0;
+	
+	sim->madctl = 0x00;
+	sim->colmod = 0x06; /* 18-bit */
+	sim->sleeping = 1;
+	sim->on = sim->inverted = sim->idle = sim->scrolling = 0;
+	sim->xs = 0; sim->xe = GRAM_COLUMNS - 1;
+	sim->ys = 0; sim->ye = GRAM_ROWS - 1;
+	sim->tfa = 0; sim->vsa = GRAM_ROWS; sim->bfa = 0; sim->ssa = 0;
+	sim->x = sim->y = 0;
+	
+	sim->readyAt = sim->clock + COMMAND_WAIT;
+	sim->wakeAt = sim->clock + RESET_WAIT;
+} /* resetState */
+
+/*
+ * Store the pixel at the address counter and move the counter.
+ * The counter wraps inside the window, like in the display driver.
+ */
+static void putPixel(simContext *sim, uint8 r, uint8 g, uint8 b)
+{
+	unsigned int width, height, x = sim->x, y = sim->y, swap;
+	uint8 *cell;
+	
+	/* The size of the memory and of the panel in the addressed axes */
+	width  = (sim->madctl & MADCTL_MV) ? GRAM_ROWS : GRAM_COLUMNS;
+	height = (sim->madctl & MADCTL_MV) ? GRAM_COLUMNS : GRAM_ROWS;
+	
+	if((x < width) && (y < height))
+	{
+		/* The mirrored axes are reflected over the visible panel */
+		width  = (sim->madctl & MADCTL_MV) ? PANEL_ROWS : PANEL_COLUMNS;
+		height = (sim->madctl & MADCTL_MV) ? PANEL_COLUMNS : PANEL_ROWS;
+		if((sim->madctl & MADCTL_MX) && (x < width)) x = width - 1 - x;
+		if((sim->madctl & MADCTL_MY) && (y < height)) y = height - 1 - y;
+		if(sim->madctl & MADCTL_MV) { swap = x; x = y; y = swap; }
+	
+		cell = sim->gram[y][x];
+		cell[0] = (sim->madctl & MADCTL_BGR) ? b : r;
+		cell[1] = g;
+		cell[2] = (sim->madctl & MADCTL_BGR) ? r : b;
+		sim->stats.pixels++;
+	}
+	
+	if(++sim->x > sim->xe)
+	{
+		sim->x = sim->xs;
+		if(++sim->y > sim->ye) sim->y = sim->ys;
+	}
+} /* putPixel */
+
+/*
+ * Collect the bits of the pixels of the Memory Write command.
+ * The panel takes the pixel, when all its bits are received.
+ */
+static void writeMemory(simContext *sim, uint8 data)
+{
+	unsigned long v;
+	
+	sim->bits = (sim->bits << 8) | data;
+	sim->bitCount += 8;
+	
+	switch(sim->colmod & 0x07)
+	{
+		case 0x03: /* 12-bit; 4 bits per component */
+			while(sim->bitCount >= 12)
+			{
+				sim->bitCount -= 12;
+				v = sim->bits >> sim->bitCount;
+				putPixel(sim, ((v >> 6) & 0x3C) | ((v >> 10) & 0x03),
+						 ((v >> 2) & 0x3C) | ((v >> 6) & 0x03),
+						 ((v << 2) & 0x3C) | ((v >> 2) & 0x03));
+			}
+			break;
+	
+		case 0x05: /* 16-bit; RGB565 */
+			if(sim->bitCount < 16) break;
+			sim->bitCount = 0;
+			v = sim->bits & 0xFFFF;
+			putPixel(sim, ((v >> 10) & 0x3E) | (v >> 15),
+					 (v >> 5) & 0x3F, ((v << 1) & 0x3E) | ((v >> 4) & 0x01));
+			break;
+	
+		default: /* 18-bit; The upper 6 bits of 3 bytes */
+			if(sim->bitCount < 24) break;
+			sim->bitCount = 0;
+			v = sim->bits & 0xFFFFFF;
+			putPixel(sim, (v >> 18) & 0x3F, (v >> 10) & 0x3F, (v >> 2) & 0x3F);
+			break;
+	}
+	
+	sim->bits &= 0xFFFF;
+} /* writeMemory */
+
+/*
+ * Start the command. The incomplete parameters and pixels are dropped.
+ */
+static void startCommand(simContext *sim, uint8 command)
+{
+	sim->stats.commands++;
+	if((sim->clock < sim->readyAt)
+	|| ((command == ST7735S_CMD_SLPOUT) && (sim->clock < sim->wakeAt)))
+		sim->stats.violations++;
+	
+	sim->command = command;
+	sim->paramCount = 0;
+	sim->bitCount = 0;
+	
+	switch(command)
+	{
+		case ST7735S_CMD_SWRESET: resetState(sim); break;
+		case ST7735S_CMD_SLPIN:   sim->sleeping = 1; break;
+		case ST7735S_CMD_PTLON:   sim->scrolling = 0; break;
+		case ST7735S_CMD_NORON:   sim->scrolling = 0; break;
+		case ST7735S_CMD_INVOFF:  sim->inverted = 0; break;
+		case ST7735S_CMD_INVON:   sim->inverted = 1; break;
+		case ST7735S_CMD_DISPOFF: sim->on = 0; break;
+		case ST7735S_CMD_DISPON:  sim->on = 1; break;
+		case ST7735S_CMD_IDMOFF:  sim->idle = 0; break;
+		case ST7735S_CMD_IDMON:   sim->idle = 1; break;
+	
+		case ST7735S_CMD_SLPOUT:
+			sim->sleeping = 0;
+			sim->readyAt = sim->clock + COMMAND_WAIT;
+			break;
+	
+		case ST7735S_CMD_RAMWR:
+			sim->x = sim->xs;
+			sim->y = sim->ys;
+			break;
+	}
+} /* startCommand */
+
+/*
+ * Take the parameter of the current command.
+ */
+static void writeParameter(simContext *sim, uint8 data)
+{
+	uint8 *p = sim->params;
+	
+	if(sim->command == ST7735S_CMD_RAMWR)
+	{
+		writeMemory(sim, data);
+		return;
+	}
+	
+	if(sim->paramCount < sizeof(sim->params)) p[sim->paramCount] = data;
+	sim->paramCount++;
+	
+	switch(sim->command)
+	{
+		case ST7735S_CMD_CASET:
+			if(sim->paramCount != 4) break;
+			sim->xs = (p[0] << 8) | p[1];
+			sim->xe = (p[2] << 8) | p[3];
+			break;
+	
+		case ST7735S_CMD_RASET:
+			if(sim->paramCount != 4) break;
+			sim->ys = (p[0] << 8) | p[1];
+			sim->ye = (p[2] << 8) | p[3];
+			break;
+	
+		case ST7735S_CMD_MADCTL:
+			if(sim->paramCount == 1) sim->madctl = data;
+			break;
+	
+		case ST7735S_CMD_COLMOD:
+			if(sim->paramCount == 1) sim->colmod = data;
+			break;
+	
+		case ST7735S_CMD_VSCRDEF:
+			if(sim->paramCount != 6) break;
+			sim->tfa = (p[0] << 8) | p[1];
+			sim->vsa = (p[2] << 8) | p[3];
+			sim->bfa = (p[4] << 8) | p[5];
+			break;
+	
+		case ST7735S_CMD_VSCSAD:
+			if(sim->paramCount != 2) break;
+			sim->ssa = (p[0] << 8) | p[1];
+			sim->scrolling = 1;
+			break;
+	}
+} /* writeParameter */
+
+/*
+ * Decode the bytes sent with the current level of the D/C line.
+ */
+static void decode(simContext *sim, const uint8 *data, unsigned int length)
+{
+	unsigned int i;
+	
+	sim->clock += length * 8.0 / sim->speed;
+	sim->stats.busTime += length * 8.0 / sim->speed;
+	sim->stats.bytes += length;
+	
+	if(sim->dc) sim->stats.dataBytes += length;
+	else sim->stats.commandBytes += length;
+	
+	/* The panel ignores the bus while the reset line is low */
+	if(!sim->reset) return;
+	
+	for(i = 0; i < length; i++)
+	{
+		if(sim->dc) writeParameter(sim, data[i]);
+		else startCommand(sim, data[i]);
+	}
+} /* decode */
+
+/*
+ * Count one SPI message.
+ */
+static void startTransaction(simContext *sim)
+{
+	sim->clock += TRANSACTION_TIME;
+	sim->stats.busTime += TRANSACTION_TIME;
+	sim->stats.transactions++;
+} /* startTransaction */
+
+static void simSetDC(void *context, int level)
+{
+	simContext *sim = (simContext *) context;
+	
+	if(sim->dc == (level != 0)) return;
+	sim->dc = (level != 0);
+	sim->clock += DC_TIME;
+	sim->stats.busTime += DC_TIME;
+	sim->stats.dcChanges++;
+} /* simSetDC */
+
+static int simTransfer(void *context, const uint8 *data, unsigned int length)
+{
+	simContext *sim = (simContext *) context;
+	
+	sim->stats.calls++;
+	startTransaction(sim);
+	decode(sim, data, length);
+	return 0;
+} /* simTransfer */
+
+static int simTransferv(void *context, const lcdst_segment_t *segments,
+						unsigned int count)
+{
+	simContext *sim = (simContext *) context;
+	unsigned int i;
+	
+	sim->stats.calls++;
+	
+	/* One message for every run of the segments with one D/C level */
+	for(i = 0; i < count; i++)
+	{
+		if((i == 0) || (segments[i].dc != segments[i - 1].dc))
+		{
+			simSetDC(sim, segments[i].dc);
+			startTransaction(sim);
+		}
+		decode(sim, segments[i].data, segments[i].length);
+	}
+	
+	return 0;
+} /* simTransferv */
+
+static int simReset(void *context, int level)
+{
+	simContext *sim = (simContext *) context;
+	
+	/*
+	 * The registers are reset, when the line goes low. After the release
+	 * the driver takes 5ms in the Sleep In mode and 120ms in Sleep Out.
+	 */
+	if(sim->reset && !level)
+	{
+		sim->resetAwake = !sim->sleeping;
+		resetState(sim);
+	}
+	if(!sim->reset && level)
+	{
+		sim->readyAt = sim->clock
+			+ (sim->resetAwake ? RESET_WAIT : COMMAND_WAIT);
+		sim->wakeAt = sim->clock + RESET_WAIT;
+	}
+	sim->reset = (level != 0);
+	
+	return 0;
+} /* simReset */
+
+static void simDelay(void *context, unsigned int milliseconds)
+{
+	simContext *sim = (simContext *) context;
+	
+	sim->clock += milliseconds / 1000.0;
+	sim->stats.delayTime += milliseconds / 1000.0;
+} /* simDelay */
+
+static void simClose(void *context)
+{
+	free(context);
+} /* simClose */
+
+/* The simulated backend */
+static const lcdst_backend_t simBackend =
+{
+	simTransfer,
+	simTransferv,
+	simSetDC,
+	simReset,
+	simDelay,
+	simClose
+};
+
+/*
+ * Get the state of the simulated panel of the display.
+ *
+ * Return: Pointer to the state; NULL if it is not a simulated display.
+ */
+static simContext *getSim(lcdst_t *display)
+{
+	if((display == NULL) || (display->backend != &simBackend)) return NULL;
+	return (simContext *) display->context;
+} /* getSim */
+
+lcdst_t *lcdst_initSim(unsigned int spiSpeed)
+{
+	simContext *sim = (simContext *) calloc(1, sizeof(simContext));
+	
+	if(sim == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	sim->speed = spiSpeed ? spiSpeed : 1;
+	sim->reset = 1;
+	resetState(sim);
+	
+	/* The power was turned on long before */
+	sim->readyAt = sim->wakeAt = 0;
+	
+	return lcdst_initBackend(&simBackend, sim);
+} /* lcdst_initSim */
+
+uint8 lcdst_simGetPixel(lcdst_t *display, uint8 x, uint8 y, uint8 *rgb)
+{
+	simContext *sim = getSim(display);
+	unsigned int row = y, i;
+	long offset;
+	uint8 c;
+	
+	if((sim == NULL) || (x >= PANEL_COLUMNS) || (y >= PANEL_ROWS)) return 1;
+	
+	/* The panel is white without the image */
+	if(sim->sleeping || !sim->on)
+	{
+		rgb[0] = rgb[1] = rgb[2] = 255;
+		return 0;
+	}
+	
+	/* The rows of the scroll area start from the start address */
+	if(sim->scrolling && (sim->vsa != 0)
+	&& (row >= sim->tfa) && (row < sim->tfa + sim->vsa))
+	{
+		offset = ((long) row - sim->tfa + sim->ssa - sim->tfa) % (long) sim->vsa;
+		if(offset < 0) offset += sim->vsa;
+		row = sim->tfa + offset;
+		if(row >= GRAM_ROWS) row = GRAM_ROWS - 1;
+	}
+	
+	for(i = 0; i < 3; i++)
+	{
+		c = sim->gram[row][x][i];
+		if(sim->idle) c = (c & 0x20) ? 0x3F : 0x00; /* 8 colors */
+		if(sim->inverted) c = 0x3F - c;
+		rgb[i] = (c << 2) | (c >> 4);
+	}
+	
+	return 0;
+} /* lcdst_simGetPixel */
+
+uint8 lcdst_simWritePPM(lcdst_t *display, const char *path)
+{
+	uint8 line[PANEL_COLUMNS * 3];
+	unsigned int x, y;
+	FILE *file;
+	int result;
+	
+	if(getSim(display) == NULL) return 1;
+	
+	file = fopen(path, "wb");
+	if(file == NULL) return 1;
+	
+	result = fprintf(file, "P6\n%d %d\n255\n", PANEL_COLUMNS, PANEL_ROWS) < 0;
+	for(y = 0; (y < PANEL_ROWS) && !result; y++)
+	{
+		for(x = 0; x < PANEL_COLUMNS; x++)
+			lcdst_simGetPixel(display, x, y, line + x * 3);
+		result = fwrite(line, sizeof(line), 1, file) != 1;
+	}
+	
+	result |= fclose(file) != 0;
+	return result;
+} /* lcdst_simWritePPM */
+
+uint8 lcdst_simGetStats(lcdst_t *display, lcdst_simstats_t *stats)
+{
+	simContext *sim = getSim(display);
+	
+	if(sim == NULL) return 1;
+	*stats = sim->stats;
+	return 0;
+} /* lcdst_simGetStats */
+
+void lcdst_simResetStats(lcdst_t *display)
+{
+	simContext *sim = getSim(display);
+	
+	if(sim != NULL) memset(&sim->stats, 0, sizeof(sim->stats));
+} /* lcdst_simResetStats */
@@ -0,0 +1,101 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#ifndef _LIBRARY_ST7735S_SIM_
+#define _LIBRARY_ST7735S_SIM_
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The statistics of the simulated panel */
+typedef struct
+{
+	unsigned long long bytes;        /* All bytes sent through the SPI */
+	unsigned long long commandBytes; /* Bytes sent with the D/C line low */
+	unsigned long long dataBytes;    /* Bytes sent with the D/C line high */
+	unsigned long long pixels;       /* Pixels written to the memory */
+	unsigned long calls;             /* Calls of the backend transfers */
+	unsigned long transactions;      /* SPI messages; One per D/C level run */
+	unsigned long commands;          /* Interpreted commands */
+	unsigned long dcChanges;         /* Changes of the D/C line level */
+	unsigned long violations;        /* Commands sent too early after reset */
+	double busTime;                  /* Modeled time of the SPI transfers */
+	double delayTime;                /* The time of the backend delays */
+} lcdst_simstats_t;
+
+/*
+ * Initialize the simulated display and create a data structure for it.
+ * The last initialized display is active.
+ *
+ * The backend decodes the command stream like the display driver and
+ * keeps the emulated 132x162 frame memory with its address counter and
+ * the memory access control. The visible panel has 128x160 pixels and
+ * the mirrored axes are reflected over it; The spare columns and rows of
+ * the memory lie after it. The SPI time is modeled from the speed and
+ * the cost of the transactions, the delays do not wait.
+ *
+ * Parameters:
+ *   spiSpeed - Modeled speed of the SPI interface in Hz.
+ *
+ * Return: Pointer to the structure with display data.
+ *
+ */
+lcdst_t *lcdst_initSim(unsigned int spiSpeed);
+
+/*
+ * Read the color of the pixel of the visible panel, as it is shown.
+ * The scrolling, the inversion and the idle mode are applied.
+ * The coordinates are in the native portrait orientation of the panel.
+ *
+ * Parameters:
+ *   display - Pointer to the structure of the simulated display.
+ *   x - The column of the panel; 0 to 127.
+ *   y - The row of the panel; 0 to 159.
+ *   rgb - Pointer to 3 bytes for the color components; 0 to 255.
+ *
+ * Return: 0 - OK; 1 - Not a simulated display or wrong coordinates.
+ */
+uint8 lcdst_simGetPixel(lcdst_t *display, uint8 x, uint8 y, uint8 *rgb);
+
+/*
+ * Save the visible panel to the binary PPM file.
+ *
+ * Parameters:
+ *   display - Pointer to the structure of the simulated display.
+ *   path - Path to the output file.
+ *
+ * Return: 0 - OK; 1 - Not a simulated display or a write error.
+ */
+uint8 lcdst_simWritePPM(lcdst_t *display, const char *path);
+
+/*
+ * Copy the statistics of the simulated display.
+ *
+ * Parameters:
+ *   display - Pointer to the structure of the simulated display.
+ *   stats - Pointer to the structure for the statistics.
+ *
+ * Return: 0 - OK; 1 - Not a simulated display.
+ */
+uint8 lcdst_simGetStats(lcdst_t *display, lcdst_simstats_t *stats);
+
+/*
+ * Clear the statistics of the simulated display.
+ *
+ * Parameters:
+ *   display - Pointer to the structure of the simulated display.
+ *
+ * Return: void
+ */
+void lcdst_simResetStats(lcdst_t *display);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_SIM_ */
@@ -0,0 +1,421 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <linux/gpio.h>
+#include "st7735s_spidev.h"
+
+/* The maximum number of transfers chained in one SPI_IOC_MESSAGE */
+#define MAX_TRANSFERS 32
+
+/* The default limit of one message of the spidev kernel module */
+#define DEFAULT_BUFSIZ 4096
+
+/* The bits of the lines in the request of the GPIO character device */
+#define LINE_A0 0x01
+#define LINE_RS 0x02
+
+/* The state of one display connected through spidev */
+typedef struct
+{
+	int spi;             /* The spidev file descriptor */
+	int a0, rs;          /* The value file descriptors of the GPIO lines */
+	int lines;           /* The line request of the GPIO chip; -1 = sysfs */
+	int dcLevel;         /* The last level of the D/C line; -1 = unknown */
+	unsigned int speed;  /* The speed of the SPI interface in Hz */
+	unsigned int bufsiz; /* The limit of one message in bytes */
+} spidevContext;
+
+/*
+ * Write the text to the sysfs file.
+ *
+ * Return: 0 on success; 1 on error.
+ */
+static int writeFile(const char *path, const char *text)
+{
+	int fd = open(path, O_WRONLY);
+	int result;
+	
+	if(fd == -1) return 1;
+	result = write(fd, text, strlen(text)) != (ssize_t) strlen(text);
+	close(fd);
+	
+	return result;
+} /* writeFile */
+
+/*
+ * Export the GPIO line through sysfs and configure it as an output.
+ *
+ * Return: The file descriptor of the 'value' file; -1 on error.
+ */
+static int openLine(int line)
+{
+	char path[64], number[16];
+	
+	snprintf(number, sizeof(number), "%d", line);
+	snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/direction", line);
+	
+	/* The line can be exported already */
+	if(access(path, F_OK) != 0)
+		writeFile("/sys/class/gpio/export", number);
+	
+	/* The line starts high, so the running display is not reset */
+	if(writeFile(path, "high")) return -1;
+	
+	snprintf(path, sizeof(path), "/sys/class/gpio/gpio%d/value", line);
+	return open(path, O_WRONLY);
+} /* openLine */
+
+/*
+ * Read the limit of one message from the spidev module parameter.
+ */
+static unsigned int readBufsiz(void)
+{
+	FILE *file = fopen("/sys/module/spidev/parameters/bufsiz", "r");
+	unsigned int bufsiz = DEFAULT_BUFSIZ;
+	
+	if(file == NULL) return bufsiz;
+	if(fscanf(file, "%u", &bufsiz) != 1 || bufsiz == 0)
+		bufsiz = DEFAULT_BUFSIZ;
+	fclose(file);
+	
+	return bufsiz;
+} /* readBufsiz */
+
+/*
+ * Request the output lines from the GPIO character device.
+ * The lines start high; Data mode and the reset off.
+ *
+ * Return: The file descriptor of the line request; -1 on error.
+ */
+static int requestLines(const char *chip, int a0, int rs)
+{
+	struct gpio_v2_line_request request;
+	int fd = open(chip, O_RDONLY | O_CLOEXEC);
+	int result;
+	
+	if(fd == -1) return -1;
+	
+	memset(&request, 0, sizeof(request));
+	strncpy(request.consumer, "st7735s", sizeof(request.consumer) - 1);
+	request.offsets[0] = a0;
+	request.offsets[1] = rs;
+	request.num_lines = (rs == -1) ? 1 : 2;
+	request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+	request.config.num_attrs = 1;
+	request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+	request.config.attrs[0].attr.values = LINE_A0 | LINE_RS;
+	request.config.attrs[0].mask = LINE_A0 | LINE_RS;
+	
+	result = ioctl(fd, GPIO_V2_GET_LINE_IOCTL, &request);
+	close(fd);
+	
+	return (result == -1) ? -1 : request.fd;
+} /* requestLines */
+
+/*
+ * Set the level of the GPIO line through the line request
+ * or through the sysfs file.
+ *
+ * Return: 0 on success; 1 on error.
+ */
+static int setLine(spidevContext *spidev, int line, int fd, int level)
+{
+	struct gpio_v2_line_values values;
+	
+	if(spidev->lines == -1)
+		return pwrite(fd, level ? "1" : "0", 1, 0) != 1;
+	
+	values.bits = level ? line : 0;
+	values.mask = line;
+	return ioctl(spidev->lines, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) == -1;
+} /* setLine */
+
+static void spidevSetDC(void *context, int level)
+{
+	spidevContext *spidev = (spidevContext *) context;
+	
+	/* The messages of one level often follow each other */
+	level = (level != 0);
+	if(spidev->dcLevel == level) return;
+	
+	if(setLine(spidev, LINE_A0, spidev->a0, level))
+	{
+		fprintf(stderr, "Failed to set the D/C line!\n");
+		spidev->dcLevel = -1;
+		return;
+	}
+	spidev->dcLevel = level;
+} /* spidevSetDC */
+
+/*
+ * Send the chained transfers in one kernel round trip.
+ */
+static int sendMessage(spidevContext *spidev,
+					   struct spi_ioc_transfer *transfers, unsigned int count)
+{
+	if(count == 0) return 0;
+	return ioctl(spidev->spi, SPI_IOC_MESSAGE(count), transfers) < 0;
+} /* sendMessage */
+
+/*
+ * Add the bytes to the chained transfers. The full message is sent
+ * and the chain starts again.
+ *
+ * Return: 0 - OK; 1 - Sending of a full message failed.
+ */
+static int chainBytes(spidevContext *spidev,
+					  struct spi_ioc_transfer *transfers, unsigned int *used,
+					  unsigned int *bytes, const uint8 *data,
+					  unsigned int length)
+{
+	unsigned int offset, part;
+	int result = 0;
+	
+	for(offset = 0; offset < length; offset += part)
+	{
+		part = length - offset;
+		if(part > spidev->bufsiz - *bytes) part = spidev->bufsiz - *bytes;
+		
+		transfers[*used].tx_buf = (unsigned long) (data + offset);
+		transfers[*used].rx_buf = 0; /* Write only */
+		transfers[*used].len = part;
+		transfers[*used].speed_hz = spidev->speed;
+		transfers[*used].bits_per_word = 8;
+		(*used)++;
+		*bytes += part;
+		
+		/* The message is full */
+		if((*used == MAX_TRANSFERS) || (*bytes == spidev->bufsiz))
+		{
+			result |= sendMessage(spidev, transfers, *used);
+			memset(transfers, 0, *used * sizeof(transfers[0]));
+			*used = *bytes = 0;
+		}
+	}
+	
+	return result;
+} /* chainBytes */
+
+static int spidevTransferv(void *context, const lcdst_segment_t *segments,
+						   unsigned int count)
+{
+	spidevContext *spidev = (spidevContext *) context;
+	struct spi_ioc_transfer transfers[MAX_TRANSFERS];
+	unsigned int used = 0, bytes = 0, i = 0;
+	int result = 0;
+	uint8 dc;
+	
+	memset(transfers, 0, sizeof(transfers));
+	
+	while(i < count)
+	{
+		/* The D/C line can change only between the messages */
+		dc = segments[i].dc;
+		spidevSetDC(spidev, dc);
+		
+		/* Chain all consecutive segments with the same D/C level */
+		for(; (i < count) && (segments[i].dc == dc); i++)
+			result |= chainBytes(spidev, transfers, &used, &bytes,
+								 segments[i].data, segments[i].length);
+		
+		result |= sendMessage(spidev, transfers, used);
+		memset(transfers, 0, used * sizeof(transfers[0]));
+		used = bytes = 0;
+	}
+	
+	return result;
+} /* spidevTransferv */
+
+static int spidevTransfer(void *context, const uint8 *data, unsigned int length)
+{
+	spidevContext *spidev = (spidevContext *) context;
+	struct spi_ioc_transfer transfers[MAX_TRANSFERS];
+	unsigned int used = 0, bytes = 0;
+	int result;
+	
+	/* The D/C line is left as the caller set it by setDC() */
+	memset(transfers, 0, sizeof(transfers));
+	result = chainBytes(spidev, transfers, &used, &bytes, data, length);
+	return result | sendMessage(spidev, transfers, used);
+} /* spidevTransfer */
+
+static int spidevReset(void *context, int level)
+{
+	spidevContext *spidev = (spidevContext *) context;
+	
+	if(spidev->rs == -1) return 1;
+	if(setLine(spidev, LINE_RS, spidev->rs, level))
+	{
+		fprintf(stderr, "Failed to set the reset line!\n");
+		return 1;
+	}
+	
+	return 0;
+} /* spidevReset */
+
+static void spidevDelay(void *context, unsigned int milliseconds)
+{
+	struct timespec time;
+	
+	(void) context;
+	time.tv_sec  = milliseconds / 1000;
+	time.tv_nsec = (milliseconds % 1000) * 1000000L;
+	while(nanosleep(&time, &time) == -1 && errno == EINTR);
+} /* spidevDelay */
+
+static void spidevClose(void *context)
+{
+	spidevContext *spidev = (spidevContext *) context;
+	
+	close(spidev->spi);
+	if(spidev->lines != -1) close(spidev->lines);
+	else close(spidev->a0);
+	if((spidev->lines == -1) && (spidev->rs != -1)) close(spidev->rs);
+	free(spidev);
+} /* spidevClose */
+
+/* The spidev backend */
+static const lcdst_backend_t spidevBackend =
+{
+	spidevTransfer,
+	spidevTransferv,
+	spidevSetDC,
+	spidevReset,
+	spidevDelay,
+	spidevClose
+};
+
+/*
+ * Open and configure the spidev device.
+ *
+ * Return: The state of the display without the GPIO lines.
+ * If an error occurs, stop the program.
+ */
+static spidevContext *openSpidev(const char *device, unsigned int spiSpeed)
+{
+	spidevContext *spidev = (spidevContext *) malloc(sizeof(spidevContext));
+	uint8 mode = SPI_MODE_0, bits = 8;
+	
+	if(spidev == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	spidev->speed = spiSpeed;
+	spidev->bufsiz = readBufsiz();
+	spidev->lines = -1;
+	spidev->dcLevel = -1;
+	
+	/* Configure the SPI interface */
+	spidev->spi = open(device, O_RDWR);
+	if((spidev->spi == -1)
+	|| (ioctl(spidev->spi, SPI_IOC_WR_MODE, &mode) == -1)
+	|| (ioctl(spidev->spi, SPI_IOC_WR_BITS_PER_WORD, &bits) == -1)
+	|| (ioctl(spidev->spi, SPI_IOC_WR_MAX_SPEED_HZ, &spiSpeed) == -1))
+	{
+		fprintf(stderr, "Failed to setup the SPI interface!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return spidev;
+} /* openSpidev */
+
+/*
+ * Create the display for the configured spidev device, or take over
+ * the running one. The displays on the chip selects of one bus share
+ * its lock.
+ */
+static lcdst_t *createSpidev(spidevContext *spidev, const char *device,
+							 uint8 attach)
+{
+	const char *name = strrchr(device, '/');
+	int bus, cs;
+	
+	spidevReset(spidev, 1); /* Reset OFF */
+	
+	name = (name == NULL) ? device : name + 1;
+	if(sscanf(name, "spidev%d.%d", &bus, &cs) != 2) bus = -1;
+	
+	if(attach) return lcdst_attachBus(&spidevBackend, spidev, bus);
+	return lcdst_initBus(&spidevBackend, spidev, bus);
+} /* createSpidev */
+
+/*
+ * Open the spidev device and the sysfs GPIO lines.
+ */
+static spidevContext *openSysfs(const char *device, unsigned int spiSpeed,
+								int a0, int rs)
+{
+	spidevContext *spidev = openSpidev(device, spiSpeed);
+	
+	/* Configure the a0 line and the optional rs line */
+	spidev->a0 = openLine(a0);
+	spidev->rs = (rs == -1) ? -1 : openLine(rs);
+	if((spidev->a0 == -1) || ((rs != -1) && (spidev->rs == -1)))
+	{
+		fprintf(stderr, "Failed to setup the GPIO lines!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return spidev;
+} /* openSysfs */
+
+/*
+ * Open the spidev device and the lines of the GPIO chip.
+ */
+static spidevContext *openChip(const char *device, unsigned int spiSpeed,
+							   const char *chip, int a0, int rs)
+{
+	spidevContext *spidev = openSpidev(device, spiSpeed);
+	
+	/* Request the a0 line and the optional rs line together */
+	spidev->a0 = a0;
+	spidev->rs = rs;
+	spidev->lines = requestLines(chip, a0, rs);
+	if(spidev->lines == -1)
+	{
+		fprintf(stderr, "Failed to setup the GPIO lines!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return spidev;
+} /* openChip */
+
+lcdst_t *lcdst_initSpidev(const char *device, unsigned int spiSpeed,
+						  int a0, int rs)
+{
+	return createSpidev(openSysfs(device, spiSpeed, a0, rs), device, 0);
+} /* lcdst_initSpidev */
+
+lcdst_t *lcdst_attachSpidev(const char *device, unsigned int spiSpeed,
+							int a0, int rs)
+{
+	return createSpidev(openSysfs(device, spiSpeed, a0, rs), device, 1);
+} /* lcdst_attachSpidev */
+
+lcdst_t *lcdst_initSpidevChip(const char *device, unsigned int spiSpeed,
+							  const char *chip, int a0, int rs)
+{
+	return createSpidev(openChip(device, spiSpeed, chip, a0, rs), device, 0);
+} /* lcdst_initSpidevChip */
+
+lcdst_t *lcdst_attachSpidevChip(const char *device, unsigned int spiSpeed,
+								const char *chip, int a0, int rs)
+{
+	return createSpidev(openChip(device, spiSpeed, chip, a0, rs), device, 1);
+} /* lcdst_attachSpidevChip */
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#ifndef _LIBRARY_ST7735S_SPIDEV_
+#define _LIBRARY_ST7735S_SPIDEV_
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Initialize the display connected through the Linux spidev interface
+ * and create a data structure for it. The D/C and reset lines are
+ * controlled through the sysfs GPIO interface.
+ * The last initialized display is active.
+ *
+ * The backend sends the queued segments with SPI_IOC_MESSAGE, chaining
+ * all consecutive segments with the same D/C level into one ioctl call.
+ * The transfers are write-only. The D/C line is set only when its level
+ * changes between the messages.
+ *
+ * Parameters:
+ *   device - Path to the spidev device, for example "/dev/spidev0.0".
+ *   spiSpeed - Speed of the SPI interface in Hz.
+ *   a0 - Data/Command line; Number of the GPIO in the kernel.
+ *   rs - Optional reset line; Number of the GPIO in the kernel.
+ *        If you do not use it, enter -1.
+ *
+ * Return: Pointer to the structure with display data.
+ *
+ */
+lcdst_t *lcdst_initSpidev(const char *device, unsigned int spiSpeed,
+						  int a0, int rs);
+
+/*
+ * Initialize the display connected through the Linux spidev interface,
+ * like lcdst_initSpidev(), but control the D/C and reset lines through
+ * the GPIO character device. Both lines are held in one line request,
+ * so every level change is one ioctl call without the sysfs files.
+ * The lines of the gpio-sim and gpio-mockup modules can be used as well,
+ * to check the levels of the lines without the hardware.
+ *
+ * Parameters:
+ *   device - Path to the spidev device, for example "/dev/spidev0.0".
+ *   spiSpeed - Speed of the SPI interface in Hz.
+ *   chip - Path to the GPIO chip, for example "/dev/gpiochip0".
+ *   a0 - Data/Command line; The offset of the line on the chip.
+ *   rs - Optional reset line; The offset of the line on the chip.
+ *        If you do not use it, enter -1.
+ *
+ * Return: Pointer to the structure with display data.
+ *
+ */
+lcdst_t *lcdst_initSpidevChip(const char *device, unsigned int spiSpeed,
+							  const char *chip, int a0, int rs);
+
+/*
+ * Take over the display, which was started by another process, without
+ * the reset and the waits. They work like lcdst_initSpidev() and
+ * lcdst_initSpidevChip() with lcdst_attachBus() instead of the start.
+ * The last attached display is active.
+ */
+lcdst_t *lcdst_attachSpidev(const char *device, unsigned int spiSpeed,
+							int a0, int rs);
+lcdst_t *lcdst_attachSpidevChip(const char *device, unsigned int spiSpeed,
+								const char *chip, int a0, int rs);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_SPIDEV_ */
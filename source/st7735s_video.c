@@ -0,0 +1,408 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "st7735s.h"
+#include "st7735s_asset.h"
+#include "st7735s_video.h"
+
+/*
+ * Allocate the memory block. If an error occurs, stop the program.
+ *
+ * Parameters:
+ *   size - Size of memory block to allocate.
+ *
+ * Return:
+ *   Pointer to the memory block. If an error occurs, stop the program.
+ */
+static void *safeMalloc(size_t size)
+{
+	void *memoryBlock = malloc(size);
+	
+	/* Check the pointer */
+	if(memoryBlock == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	return memoryBlock;
+} /* safeMalloc */
+
+/* Read the little-endian numbers of the header */
+static inline unsigned int read16(const uint8 *p)
+{
+	return p[0] | (p[1] << 8);
+} /* read16 */
+
+static inline unsigned long read32(const uint8 *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long) p[3] << 24);
+} /* read32 */
+
+/*
+ * Read the monotonic clock in nanoseconds.
+ */
+static inline unsigned long long clockNs(void)
+{
+	struct timespec time;
+	
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000ULL + time.tv_nsec;
+} /* clockNs */
+
+/*
+ * Read the bytes from the pipe; It may return less at a time.
+ *
+ * Return: The number of read bytes; Less at the end or on an error.
+ */
+static size_t readFully(int fd, uint8 *buffer, size_t length)
+{
+	size_t done = 0;
+	ssize_t n;
+	
+	while(done < length)
+	{
+		n = read(fd, buffer + done, length - done);
+		if((n == -1) && (errno == EINTR)) continue;
+		if(n <= 0) break;
+		done += n;
+	}
+	
+	return done;
+} /* readFully */
+
+/* Get the bytes of one unit of the RLE packets */
+static inline unsigned int unitSize(uint8 pixel)
+{
+	return (pixel == ST7735S_PIXEL_MEDIUM) ? 2 : 3;
+} /* unitSize */
+
+/*
+ * Get the largest valid RLE frame; Every 128 units need one byte more.
+ */
+static inline size_t packetLimit(const lcdst_video_t *video)
+{
+	size_t units = video->frameSize / unitSize(video->pixel);
+	
+	return video->frameSize + (units + 127) / 128;
+} /* packetLimit */
+
+/*
+ * Check the header and create the video with the buffers.
+ *
+ * Return: Pointer to the video; NULL if the header is not valid.
+ */
+static lcdst_video_t *parseHeader(const uint8 *header)
+{
+	lcdst_video_t *video;
+	
+	if(memcmp(header, ST7735S_VIDEO_MAGIC, 4)) return NULL;
+	if(header[4] != ST7735S_VIDEO_VERSION) return NULL;
+	if((header[5] != ST7735S_PIXEL_FULL) && (header[5] != ST7735S_PIXEL_MEDIUM)
+	&& (header[5] != ST7735S_PIXEL_REDUCED)) return NULL;
+	if((header[6] != ST7735S_VIDEO_RAW) && (header[6] != ST7735S_VIDEO_RLE))
+		return NULL;
+	if((read16(header + 8) == 0) || (read16(header + 10) == 0)) return NULL;
+	
+	/* The reduced frame must end on the whole byte */
+	if((header[5] == ST7735S_PIXEL_REDUCED)
+	&& (read16(header + 8) * read16(header + 10) % 2)) return NULL;
+	
+	video = (lcdst_video_t *) safeMalloc(sizeof(lcdst_video_t));
+	video->pixel = header[5];
+	video->compression = header[6];
+	video->width = read16(header + 8);
+	video->height = read16(header + 10);
+	video->fps = read16(header + 12);
+	video->frameSize = lcdst_getEncodedSize(video->pixel,
+		(size_t) video->width * video->height);
+	video->data = NULL;
+	video->size = 0;
+	video->offset = ST7735S_VIDEO_HEADER;
+	video->mapped = 0;
+	video->fd = -1;
+	video->frame = (uint8 *) safeMalloc(video->frameSize);
+	video->packets = NULL;
+	video->packetSize = 0;
+	video->broken = 0;
+	
+	return video;
+} /* parseHeader */
+
+lcdst_video_t *lcdst_openVideo(const char *path)
+{
+	uint8 header[ST7735S_VIDEO_HEADER];
+	lcdst_video_t *video;
+	struct stat info;
+	void *map;
+	int fd;
+	
+	fd = strcmp(path, "-") ? open(path, O_RDONLY | O_CLOEXEC) : dup(0);
+	if(fd == -1) return NULL;
+	if(fstat(fd, &info) == -1) {close(fd); return NULL;}
+	
+	/* The pipe is read frame by frame */
+	if(!S_ISREG(info.st_mode))
+	{
+		if((readFully(fd, header, ST7735S_VIDEO_HEADER) != ST7735S_VIDEO_HEADER)
+		|| ((video = parseHeader(header)) == NULL))
+		{
+			close(fd);
+			return NULL;
+		}
+	
+		video->fd = fd;
+		if(video->compression == ST7735S_VIDEO_RLE)
+		{
+			video->packetSize = packetLimit(video);
+			video->packets = (uint8 *) safeMalloc(video->packetSize);
+		}
+		return video;
+	}
+	
+	/* The mapping stays valid after the file is closed */
+	if(info.st_size < ST7735S_VIDEO_HEADER) {close(fd); return NULL;}
+	map = mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED) return NULL;
+	
+	video = lcdst_openVideoMemory((const uint8 *) map, info.st_size);
+	if(video == NULL)
+	{
+		munmap(map, info.st_size);
+		return NULL;
+	}
+	
+	video->mapped = 1;
+	return video;
+} /* lcdst_openVideo */
+
+lcdst_video_t *lcdst_openVideoMemory(const uint8 *data, size_t size)
+{
+	lcdst_video_t *video;
+	
+	if((data == NULL) || (size < ST7735S_VIDEO_HEADER)) return NULL;
+	
+	video = parseHeader(data);
+	if(video == NULL) return NULL;
+	
+	video->data = data;
+	video->size = size;
+	return video;
+} /* lcdst_openVideoMemory */
+
+void lcdst_closeVideo(lcdst_video_t *video)
+{
+	if(video == NULL) return;
+	
+	if(video->mapped) munmap((void *) video->data, video->size);
+	if(video->fd != -1) close(video->fd);
+	free(video->packets);
+	free(video->frame);
+	free(video);
+} /* lcdst_closeVideo */
+
+/*
+ * Decode the RLE packets to the frame of the video.
+ *
+ * Return: 0 - OK; 1 - The packets do not fill the frame exactly.
+ */
+static uint8 decodeRLE(lcdst_video_t *video, const uint8 *packets,
+					   size_t length)
+{
+	unsigned int unit = unitSize(video->pixel), n;
+	const uint8 *end = packets + length;
+	uint8 *to = video->frame, *last = video->frame + video->frameSize;
+	
+	while(packets < end)
+	{
+		n = *packets++;
+	
+		/* The different units */
+		if(n < 128)
+		{
+			n = (n + 1) * unit;
+			if(((size_t) (end - packets) < n) || ((size_t) (last - to) < n))
+				return 1;
+			memcpy(to, packets, n);
+			packets += n;
+			to += n;
+			continue;
+		}
+	
+		/* The repeated unit */
+		n -= 126;
+		if(((size_t) (end - packets) < unit)
+		|| ((size_t) (last - to) < n * unit)) return 1;
+		for(; n; n--, to += unit) memcpy(to, packets, unit);
+		packets += unit;
+	}
+	
+	return to != last;
+} /* decodeRLE */
+
+const uint8 *lcdst_readVideoFrame(lcdst_video_t *video)
+{
+	const uint8 *packets, *frame;
+	uint8 head[4];
+	size_t length, done;
+	
+	if(video->fd != -1)
+	{
+		/* The pipe; The frame is read to the buffer */
+		if(video->compression == ST7735S_VIDEO_RAW)
+		{
+			done = readFully(video->fd, video->frame, video->frameSize);
+			if(done == video->frameSize) return video->frame;
+			video->broken = (done != 0);
+			return NULL;
+		}
+	
+		done = readFully(video->fd, head, 4);
+		if(done != 4) {video->broken = (done != 0); return NULL;}
+		length = read32(head);
+		if((length > video->packetSize)
+		|| (readFully(video->fd, video->packets, length) != length))
+		{
+			video->broken = 1;
+			return NULL;
+		}
+		packets = video->packets;
+	}
+	else
+	{
+		/* The memory; The end of the data is the end of the video */
+		if(video->offset == video->size) return NULL;
+		video->broken = 1;
+	
+		/* The raw frame is used in place */
+		if(video->compression == ST7735S_VIDEO_RAW)
+		{
+			if(video->size - video->offset < video->frameSize) return NULL;
+			frame = video->data + video->offset;
+			video->offset += video->frameSize;
+			video->broken = 0;
+			return frame;
+		}
+	
+		if(video->size - video->offset < 4) return NULL;
+		length = read32(video->data + video->offset);
+		if(video->size - video->offset - 4 < length) return NULL;
+		packets = video->data + video->offset + 4;
+		video->offset += 4 + length;
+		video->broken = 0;
+	}
+	
+	if(!decodeRLE(video, packets, length)) return video->frame;
+	video->broken = 1;
+	return NULL;
+} /* lcdst_readVideoFrame */
+
+uint8 lcdst_rewindVideo(lcdst_video_t *video)
+{
+	if(video->fd != -1) return 1;
+	
+	video->offset = ST7735S_VIDEO_HEADER;
+	video->broken = 0;
+	return 0;
+} /* lcdst_rewindVideo */
+
+/*
+ * Sleep until the time of the monotonic clock.
+ */
+static void sleepUntil(unsigned long long deadline)
+{
+	struct timespec time;
+	
+	time.tv_sec = deadline / 1000000000ULL;
+	time.tv_nsec = deadline % 1000000000ULL;
+	while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, NULL)
+		  == EINTR);
+} /* sleepUntil */
+
+uint8 lcdst_playVideoOn(lcdst_t *display, lcdst_video_t *video, uint8 x,
+						uint8 y, unsigned int fps, lcdst_videostats_t *stats)
+{
+	lcdst_videostats_t result = {0, 0, 0.0, 0.0, 0.0, 0.0};
+	unsigned long long period = 0, start, now, last = 0;
+	uint8 x2 = x + video->width - 1, y2 = y + video->height - 1;
+	double interval, sum = 0.0, squares = 0.0;
+	const uint8 *frame;
+	unsigned long i;
+	uint8 error = 0;
+	
+	/* The frames are sent as they are stored */
+	if((video->pixel != display->pixel) || (display->framebuffer != NULL))
+		return 1;
+	if((x + video->width > display->width)
+	|| (y + video->height > display->height)) return 1;
+	
+	if(fps == 0) fps = video->fps;
+	if(fps != 0) period = 1000000000ULL / fps;
+	
+	start = clockNs();
+	for(i = 0; (frame = lcdst_readVideoFrame(video)) != NULL; i++)
+	{
+		/* Skip the frame, if the next one is already due */
+		if(period != 0)
+		{
+			now = clockNs();
+			if(now > start + (i + 1) * period) {result.dropped++; continue;}
+			if(now < start + i * period) sleepUntil(start + i * period);
+		}
+	
+		/* The addresses are kept, so only RAMWR starts the frame again */
+		lcdst_setWindowOn(display, x, y, x2, y2);
+		lcdst_queueEncodedOn(display, frame, video->frameSize);
+		if(lcdst_sendBufferOn(display)) {error = 1; break;}
+	
+		now = clockNs();
+		if(result.frames != 0)
+		{
+			interval = (now - last) / 1e6;
+			sum += interval;
+			squares += interval * interval;
+			if(interval > result.worstMs) result.worstMs = interval;
+		}
+		last = now;
+		result.frames++;
+	}
+	
+	/* The broken frame ends the video like its end, but it is the error */
+	if((frame == NULL) && video->broken) error = 1;
+	
+	/* The rate and the jitter of the intervals between the sent frames */
+	if(result.frames > 1)
+	{
+		result.frameMs = sum / (result.frames - 1);
+		result.fps = 1000.0 / result.frameMs;
+		result.jitterMs = squares / (result.frames - 1)
+						- result.frameMs * result.frameMs;
+		result.jitterMs = result.jitterMs > 0.0 ? sqrt(result.jitterMs) : 0.0;
+	}
+	
+	if(stats != NULL) *stats = result;
+	return error;
+} /* lcdst_playVideoOn */
+
+uint8 lcdst_playVideo(lcdst_video_t *video, uint8 x, uint8 y,
+					  unsigned int fps, lcdst_videostats_t *stats)
+{
+	return lcdst_playVideoOn(lcdst_getActiveDisplay(), video, x, y, fps,
+							 stats);
+} /* lcdst_playVideo */
@@ -0,0 +1,162 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#ifndef _LIBRARY_ST7735S_VIDEO_
+#define _LIBRARY_ST7735S_VIDEO_
+#include <stddef.h>
+#include "st7735s.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The video file holds the frames already encoded in the pixel size
+ * of the display. All numbers are little-endian.
+ *
+ *   Offset  Size  Field
+ *    0       4    Magic "LCDV"
+ *    4       1    Version; ST7735S_VIDEO_VERSION
+ *    5       1    Pixel size; ST7735S_PIXEL_FULL, _MEDIUM or _REDUCED
+ *    6       1    Compression; ST7735S_VIDEO_RAW or ST7735S_VIDEO_RLE
+ *    7       1    Reserved; 0
+ *    8       2    Width of the frames
+ *   10       2    Height of the frames
+ *   12       2    Frames per second; 0 = not specified
+ *   14       2    Reserved; 0
+ *   16            The frames until the end of the file
+ *
+ * The raw frame is the pixel stream of the window. The RLE frame starts
+ * with its length in 4 bytes, followed by the packets of the units;
+ * The unit is one pixel, or two pixels of the reduced pixel size (3 bytes).
+ * The packet starts with the byte n: If n < 128, n + 1 different units
+ * follow, otherwise one unit follows, which is repeated n - 126 times.
+ * In the reduced pixel size the frame must have the even number of pixels.
+ */
+#define ST7735S_VIDEO_MAGIC "LCDV"
+#define ST7735S_VIDEO_VERSION 1
+#define ST7735S_VIDEO_HEADER 16
+#define ST7735S_VIDEO_RAW 0
+#define ST7735S_VIDEO_RLE 1
+
+/* The opened video; The source is the mapped file, the memory or the pipe */
+typedef struct
+{
+	unsigned int width, height;    /* The size of the frames */
+	unsigned int fps;              /* The frames per second; 0 = not set */
+	uint8 pixel;                   /* The pixel size of the data */
+	uint8 compression;             /* ST7735S_VIDEO_RAW or _RLE */
+	size_t frameSize;              /* The bytes of the decoded frame */
+	const uint8 *data;             /* The mapped file or the memory */
+	size_t size, offset;           /* Its size and the next frame */
+	uint8 mapped;                  /* 1 = data is mapped by lcdst_openVideo */
+	int fd;                        /* The pipe; -1 for the data */
+	uint8 *frame;                  /* The decoded frame */
+	uint8 *packets;                /* The RLE frame read from the pipe */
+	size_t packetSize;
+	uint8 broken;                  /* 1 = The last frame was not valid */
+} lcdst_video_t;
+
+/* The results of lcdst_playVideo() */
+typedef struct
+{
+	unsigned long frames;          /* The sent frames */
+	unsigned long dropped;         /* The frames skipped to keep the pace */
+	double fps;                    /* The achieved rate of the sent frames */
+	double frameMs;                /* The mean time between the frames */
+	double jitterMs;               /* Its standard deviation */
+	double worstMs;                /* The longest time between the frames */
+} lcdst_videostats_t;
+
+/*
+ * Open the video file. The regular file is mapped into the memory,
+ * the other files (the pipes, "-" for the standard input) are read.
+ * The header is checked.
+ *
+ * Parameters:
+ *   path - Path to the video file; "-" = the standard input.
+ *
+ * Return: Pointer to the video; NULL if the file can not be opened
+ *         or it is not a valid video.
+ */
+lcdst_video_t *lcdst_openVideo(const char *path);
+
+/*
+ * Open the video in the memory. The memory is not copied, so it must be
+ * valid until the video is closed.
+ *
+ * Parameters:
+ *   data - The video with the header.
+ *   size - The size of the video.
+ *
+ * Return: Pointer to the video; NULL if it is not a valid video.
+ */
+lcdst_video_t *lcdst_openVideoMemory(const uint8 *data, size_t size);
+
+/*
+ * Close the video and free its buffers.
+ *
+ * Parameters:
+ *   video - Pointer to the video.
+ *
+ * Return: void
+ */
+void lcdst_closeVideo(lcdst_video_t *video);
+
+/*
+ * Read the next frame. The raw frames from the memory are not copied.
+ *
+ * Parameters:
+ *   video - Pointer to the video.
+ *
+ * Return: Pointer to the encoded pixels of the frame, valid until the next
+ *         reading; NULL at the end of the video or if it is broken.
+ *         The broken frame sets 'broken' of the video; The end does not.
+ */
+const uint8 *lcdst_readVideoFrame(lcdst_video_t *video);
+
+/*
+ * Go back to the first frame.
+ *
+ * Parameters:
+ *   video - Pointer to the video.
+ *
+ * Return: 0 - OK; 1 - The video is read from the pipe.
+ */
+uint8 lcdst_rewindVideo(lcdst_video_t *video);
+
+/*
+ * Play the video on the currently active display. The window is set once
+ * and every frame is sent as one RAMWR burst. The frames are paced to the
+ * rate; If the sending falls behind by more than one frame, the late
+ * frames are skipped. The pixel size of the video must be the pixel size
+ * of the display and the framebuffer mode must be off.
+ * The playing stops at the first frame, which is broken or which
+ * the backend fails to send; The results of the sent frames are still given.
+ *
+ * Parameters:
+ *   video - Pointer to the video; It is played from the current frame.
+ *   x - Parameter X of the upper left corner on the display.
+ *   y - Parameter Y of the upper left corner on the display.
+ *   fps - The rate; 0 = the rate of the video; 0 in both = no pacing.
+ *   stats - Optional pointer to the structure for the results.
+ *
+ * Return: Confirmation of the occurrence or non-occurrence of an error.
+ * 0 - The error did not occur; 1 - The error occurred.
+ *
+ */
+uint8 lcdst_playVideo(lcdst_video_t *video, uint8 x, uint8 y,
+					  unsigned int fps, lcdst_videostats_t *stats);
+
+/* The function on the specified display, like in st7735s.h */
+uint8 lcdst_playVideoOn(lcdst_t *display, lcdst_video_t *video, uint8 x,
+						uint8 y, unsigned int fps, lcdst_videostats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _LIBRARY_ST7735S_VIDEO_ */
@@ -0,0 +1,166 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "st7735s.h"
+
+/********************************** EASY PORT *********************************/
+/*
+ * If you porting this code, you can change below headers and function pointers
+ * in gpio structure.
+ */
+#include <wiringPi.h>
+#include <wiringPiSPI.h>
+struct
+{
+	void (* const delay)(unsigned int milliseconds);
+	void (* const pinMode)(int pin, int mode);
+	void (* const digitalWrite)(int pin, int value);
+	int  (* const spiSetup)(int channel, int speed);
+	int  (* const spiDataRW)(int channel, uint8 *data, int length);
+} static const gpio =
+{
+	delay,
+	pinMode,
+	digitalWrite,
+	wiringPiSPISetup,
+	wiringPiSPIDataRW
+};
+/****************************** END EASY PORT END *****************************/
+
+/* The size of the bounce buffer for one SPI transfer */
+#define BOUNCE_SIZE 4096
+
+/* The pins of one display connected through the Wiring Pi library */
+typedef struct
+{
+	int cs, a0, rs;
+} wpContext;
+
+/*
+ * Send the data through the SPI interface.
+ * The wiringPiSPIDataRW() function overwrites the buffer with the received
+ * data, so the data is copied to the bounce buffer first.
+ */
+static int wpTransfer(void *context, const uint8 *data, unsigned int length)
+{
+	wpContext *pins = (wpContext *) context;
+	uint8 bounce[BOUNCE_SIZE];
+	unsigned int part;
+	
+	while(length)
+	{
+		part = length < BOUNCE_SIZE ? length : BOUNCE_SIZE;
+		memcpy(bounce, data, part);
+		if(gpio.spiDataRW(pins->cs, bounce, part) == -1) return 1;
+		data += part;
+		length -= part;
+	}
+	
+	return 0;
+} /* wpTransfer */
+
+static void wpSetDC(void *context, int level)
+{
+	gpio.digitalWrite(((wpContext *) context)->a0, level ? HIGH : LOW);
+} /* wpSetDC */
+
+static int wpReset(void *context, int level)
+{
+	wpContext *pins = (wpContext *) context;
+	
+	if(pins->rs == -1) return 1;
+	gpio.digitalWrite(pins->rs, level ? HIGH : LOW);
+	return 0;
+} /* wpReset */
+
+static void wpDelay(void *context, unsigned int milliseconds)
+{
+	(void) context;
+	gpio.delay(milliseconds);
+} /* wpDelay */
+
+static void wpClose(void *context)
+{
+	free(context);
+} /* wpClose */
+
+/* The Wiring Pi backend */
+static const lcdst_backend_t wpBackend =
+{
+	wpTransfer,
+	NULL, /* The segments are sent one by one */
+	wpSetDC,
+	wpReset,
+	wpDelay,
+	wpClose
+};
+
+/*
+ * Configure the pins and the SPI interface and create the display.
+ *
+ * Parameters:
+ *   attach - 0 = Start the display; 1 = Take over the running display.
+ */
+static lcdst_t *openPins(int spiSpeed, int cs, int a0, int rs, uint8 attach)
+{
+	lcdst_t *instance;
+	wpContext *pins = (wpContext *) malloc(sizeof(wpContext));
+	
+	if(pins == NULL)
+	{
+		fprintf(stderr, "Out of RAM memory!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	/* Assign specific pins */
+	pins->cs = cs;
+	pins->a0 = a0;
+	pins->rs = rs;
+	
+	/* Configure the a0 pin. The logic level is not significant now. */
+	gpio.pinMode(pins->a0, OUTPUT);
+	
+	/*
+	 * If the rs pin is connected then configure it. The level is set first,
+	 * so the running display is not reset when the pin becomes an output.
+	 */
+	if(pins->rs != -1)
+	{
+		gpio.digitalWrite(pins->rs, HIGH); /* Reset OFF */
+		gpio.pinMode(pins->rs, OUTPUT);
+	}
+	
+	/* Configure the SPI interface */
+	if(gpio.spiSetup(pins->cs, spiSpeed) == -1)
+	{
+		fprintf(stderr, "Failed to setup the SPI interface!\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	/* Create the display on the SPI0 bus and remember its pins */
+	if(attach) instance = lcdst_attachBus(&wpBackend, pins, 0);
+	else instance = lcdst_initBus(&wpBackend, pins, 0);
+	instance->cs = cs;
+	instance->a0 = a0;
+	instance->rs = rs;
+	
+	return instance;
+} /* openPins */
+
+lcdst_t *lcdst_init(int spiSpeed, int cs, int a0, int rs)
+{
+	return openPins(spiSpeed, cs, a0, rs, 0);
+} /* lcdst_init */
+
+lcdst_t *lcdst_attach(int spiSpeed, int cs, int a0, int rs)
+{
+	return openPins(spiSpeed, cs, a0, rs, 1);
+} /* lcdst_attach */
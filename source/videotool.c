@@ -0,0 +1,318 @@
+/*
+ * MIT License
+ * Copyright (c) 2018, Michal Kozakiewicz, github.com/michal037
+ *
+ * Version: 2.0.0
+ * Standard: GCC-C11
+ */
+
+/*
+ * The encoder and the player of the video files, see st7735s_video.h.
+ * The encoder reads the raw RGB888 frames, for example from ffmpeg:
+ *   ffmpeg -i clip.mp4 -vf scale=128:160 -f rawvideo -pix_fmt rgb24 - |
+ *   ./lcdvideo encode -p medium -c rle -r 25 128x160 - clip.lcdv
+ * The player sends the video to the simulated display, unless the spidev
+ * device is given, and reports the achieved rate and the jitter:
+ *   ./lcdvideo play -r 30 clip.lcdv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "st7735s.h"
+#include "st7735s_asset.h"
+#include "st7735s_convert.h"
+#include "st7735s_sim.h"
+#include "st7735s_spidev.h"
+#include "st7735s_video.h"
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: lcdvideo encode [-p full|medium|reduced] [-c raw|rle] [-r FPS]"
+		" WIDTHxHEIGHT input.rgb output.lcdv\n"
+		"       lcdvideo play [-r FPS] [-l LOOPS] [-s SPEED] [-d DEVICE]"
+		" [-a DC] [-g CHIP] input.lcdv\n"
+		"  -p  The pixel size of the display; full by default.\n"
+		"  -c  The compression of the frames; raw by default.\n"
+		"  -r  The frames per second; From the video by default.\n"
+		"  -l  The number of the loops of the file; 1 by default.\n"
+		"  -s  The speed of the SPI interface in Hz; 32000000 by default.\n"
+		"  -d  The spidev device; The simulated display by default.\n"
+		"  -a  The GPIO line of the D/C signal.\n"
+		"  -g  The GPIO chip of the line; The sysfs GPIO by default.\n"
+		"  Use - as the input to read the standard input.\n");
+} /* usage */
+
+/* Write the little-endian numbers */
+static void write16(uint8 *p, unsigned int value)
+{
+	p[0] = value; p[1] = value >> 8;
+} /* write16 */
+
+static void write32(uint8 *p, unsigned long value)
+{
+	p[0] = value; p[1] = value >> 8; p[2] = value >> 16; p[3] = value >> 24;
+} /* write32 */
+
+/*
+ * Compress the units to the RLE packets, see st7735s_video.h.
+ *
+ * Return: The number of bytes of the packets.
+ */
+static size_t encodeRLE(uint8 *out, const uint8 *in, size_t units,
+						unsigned int unit)
+{
+	size_t i = 0, length = 0, n;
+	
+	while(i < units)
+	{
+		/* The run of the same units */
+		for(n = 1; (i + n < units) && (n < 129)
+			&& !memcmp(in + (i + n) * unit, in + i * unit, unit); n++);
+		if(n > 1)
+		{
+			out[length++] = n + 126;
+			memcpy(out + length, in + i * unit, unit);
+			length += unit;
+			i += n;
+			continue;
+		}
+	
+		/* The different units until the next run */
+		for(n = 1; (i + n < units) && (n < 128); n++)
+			if((i + n + 1 < units) && !memcmp(in + (i + n) * unit,
+											  in + (i + n + 1) * unit, unit))
+				break;
+		out[length++] = n - 1;
+		memcpy(out + length, in + i * unit, n * unit);
+		length += n * unit;
+		i += n;
+	}
+	
+	return length;
+} /* encodeRLE */
+
+/*
+ * Encode the raw RGB888 frames to the video file.
+ *
+ * Return: 0 - OK; 1 - An error, which is already reported.
+ */
+static int encode(int argc, char *argv[])
+{
+	unsigned int width = 0, height = 0, fps = 0, unit;
+	uint8 pixel = ST7735S_PIXEL_FULL, compression = ST7735S_VIDEO_RAW;
+	uint8 header[ST7735S_VIDEO_HEADER], *rgb, *frame, *packets;
+	unsigned long frames = 0;
+	size_t count, size, length;
+	lcdst_convert_t convert;
+	FILE *input, *output;
+	int i, error = 0;
+	
+	/* The options */
+	for(i = 0; (i < argc - 3) && (argv[i][0] == '-'); i += 2)
+	{
+		if(!strcmp(argv[i], "-p"))
+		{
+			if(!strcmp(argv[i+1], "full")) pixel = ST7735S_PIXEL_FULL;
+			else if(!strcmp(argv[i+1], "medium")) pixel = ST7735S_PIXEL_MEDIUM;
+			else if(!strcmp(argv[i+1], "reduced")) pixel = ST7735S_PIXEL_REDUCED;
+			else {usage(); return 1;}
+		}
+		else if(!strcmp(argv[i], "-c"))
+		{
+			if(!strcmp(argv[i+1], "raw")) compression = ST7735S_VIDEO_RAW;
+			else if(!strcmp(argv[i+1], "rle")) compression = ST7735S_VIDEO_RLE;
+			else {usage(); return 1;}
+		}
+		else if(!strcmp(argv[i], "-r"))
+		{
+			fps = atoi(argv[i+1]);
+			if(fps > 0xFFFF) {usage(); return 1;}
+		}
+		else {usage(); return 1;}
+	}
+	if(i != argc - 3) {usage(); return 1;}
+	if((sscanf(argv[i], "%ux%u", &width, &height) != 2)
+	|| (width == 0) || (height == 0) || (width > 0xFFFF) || (height > 0xFFFF)
+	|| ((pixel == ST7735S_PIXEL_REDUCED) && (width * height % 2)))
+	{
+		fprintf(stderr, "Wrong size of the frames %s!\n", argv[i]);
+		return 1;
+	}
+	
+	input = strcmp(argv[i+1], "-") ? fopen(argv[i+1], "rb") : stdin;
+	if(input == NULL)
+	{
+		fprintf(stderr, "Failed to open %s!\n", argv[i+1]);
+		return 1;
+	}
+	output = fopen(argv[i+2], "wb");
+	if(output == NULL)
+	{
+		fprintf(stderr, "Failed to create %s!\n", argv[i+2]);
+		if(input != stdin) fclose(input);
+		return 1;
+	}
+	
+	memcpy(header, ST7735S_VIDEO_MAGIC, 4);
+	header[4] = ST7735S_VIDEO_VERSION;
+	header[5] = pixel;
+	header[6] = compression;
+	header[7] = 0;
+	write16(header + 8, width);
+	write16(header + 10, height);
+	write16(header + 12, fps);
+	write16(header + 14, 0);
+	if(fwrite(header, 1, ST7735S_VIDEO_HEADER, output) != ST7735S_VIDEO_HEADER)
+		error = 1;
+	
+	/* The packets have the length before them and one byte per 128 units */
+	count = (size_t) width * height;
+	size = lcdst_getEncodedSize(pixel, count);
+	unit = (pixel == ST7735S_PIXEL_MEDIUM) ? 2 : 3;
+	convert = lcdst_getConverter(ST7735S_SRC_RGB888, pixel);
+	rgb = (uint8 *) malloc(count * 3);
+	frame = (uint8 *) malloc(size);
+	packets = (uint8 *) malloc(4 + size + size / unit / 128 + 1);
+	if((rgb == NULL) || (frame == NULL) || (packets == NULL)) error = 1;
+	
+	while(!error && (fread(rgb, 3, count, input) == count))
+	{
+		convert(frame, rgb, count);
+		if(compression == ST7735S_VIDEO_RAW)
+		{
+			if(fwrite(frame, 1, size, output) != size) error = 1;
+		}
+		else
+		{
+			length = encodeRLE(packets + 4, frame, size / unit, unit);
+			write32(packets, length);
+			if(fwrite(packets, 1, length + 4, output) != length + 4) error = 1;
+		}
+		frames++;
+	}
+	
+	if(input != stdin) fclose(input);
+	if(fclose(output)) error = 1;
+	free(packets);
+	free(frame);
+	free(rgb);
+	if(error)
+	{
+		fprintf(stderr, "Failed to write %s!\n", argv[i+2]);
+		remove(argv[i+2]);
+		return 1;
+	}
+	
+	fprintf(stderr, "Encoded %lu frames.\n", frames);
+	return 0;
+} /* encode */
+
+/*
+ * Play the video file and print the results.
+ *
+ * Return: 0 - OK; 1 - An error, which is already reported.
+ */
+static int play(int argc, char *argv[])
+{
+	unsigned int fps = 0, loops = 1, speed = 32000000, loop;
+	const char *device = NULL, *chip = NULL;
+	lcdst_videostats_t stats, total;
+	lcdst_simstats_t simStats;
+	lcdst_video_t *video;
+	lcdst_t *display;
+	int i, dc = -1, error = 0;
+	
+	/* The options */
+	for(i = 0; (i < argc - 1) && (argv[i][0] == '-') && argv[i][1]; i += 2)
+	{
+		if(!strcmp(argv[i], "-r")) fps = atoi(argv[i+1]);
+		else if(!strcmp(argv[i], "-l")) loops = atoi(argv[i+1]);
+		else if(!strcmp(argv[i], "-s")) speed = atoi(argv[i+1]);
+		else if(!strcmp(argv[i], "-d")) device = argv[i+1];
+		else if(!strcmp(argv[i], "-a")) dc = atoi(argv[i+1]);
+		else if(!strcmp(argv[i], "-g")) chip = argv[i+1];
+		else {usage(); return 1;}
+	}
+	if((i != argc - 1) || (loops == 0) || ((device != NULL) && (dc < 0)))
+	{
+		usage();
+		return 1;
+	}
+	
+	video = lcdst_openVideo(argv[i]);
+	if(video == NULL)
+	{
+		fprintf(stderr, "Failed to open the video %s!\n", argv[i]);
+		return 1;
+	}
+	
+	if(device == NULL) display = lcdst_initSim(speed);
+	else if(chip == NULL) display = lcdst_initSpidev(device, speed, dc, -1);
+	else display = lcdst_initSpidevChip(device, speed, chip, dc, -1);
+	if(display == NULL)
+	{
+		fprintf(stderr, "Failed to open the display %s!\n", device);
+		lcdst_closeVideo(video);
+		return 1;
+	}
+	lcdst_setPixelFormatOn(display, video->pixel);
+	if(video->width > video->height) lcdst_setOrientationOn(display, 1);
+	lcdst_simResetStats(display);
+	
+	/* The loops are added up; Their intervals are weighted by the frames */
+	memset(&total, 0, sizeof(total));
+	for(loop = 0; loop < loops; loop++)
+	{
+		if(loop && lcdst_rewindVideo(video)) break;
+		memset(&stats, 0, sizeof(stats));
+		error = lcdst_playVideoOn(display, video, 0, 0, fps, &stats);
+	
+		/* The failed loop still has the results of the sent frames */
+		total.frames += stats.frames;
+		total.dropped += stats.dropped;
+		total.frameMs += stats.frameMs * stats.frames;
+		total.jitterMs += stats.jitterMs * stats.frames;
+		if(stats.worstMs > total.worstMs) total.worstMs = stats.worstMs;
+		if(error)
+		{
+			fprintf(stderr, video->broken ? "The video is broken!\n"
+					: "Failed to play the video on the display!\n");
+			break;
+		}
+	}
+	if(total.frames)
+	{
+		total.frameMs /= total.frames;
+		total.jitterMs /= total.frames;
+		total.fps = total.frameMs > 0.0 ? 1000.0 / total.frameMs : 0.0;
+	}
+	
+	printf("{\"frames\": %lu, \"dropped\": %lu, \"fps\": %.2f, "
+		   "\"frameMs\": %.3f, \"jitterMs\": %.3f, \"worstMs\": %.3f",
+		   total.frames, total.dropped, total.fps, total.frameMs,
+		   total.jitterMs, total.worstMs);
+	
+	/* The simulated panel models the time of the SPI interface */
+	if(!lcdst_simGetStats(display, &simStats) && total.frames)
+		printf(", \"busMsPerFrame\": %.3f, \"busFps\": %.2f",
+			   simStats.busTime * 1000.0 / total.frames,
+			   simStats.busTime > 0.0 ? total.frames / simStats.busTime : 0.0);
+	printf("}\n");
+	
+	lcdst_uninit(display);
+	lcdst_closeVideo(video);
+	return error;
+} /* play */
+
+int main(int argc, char *argv[])
+{
+	if((argc > 1) && !strcmp(argv[1], "encode"))
+		return encode(argc - 2, argv + 2);
+	if((argc > 1) && !strcmp(argv[1], "play"))
+		return play(argc - 2, argv + 2);
+	
+	usage();
+	return 1;
+} /* main */